@@ -34,7 +34,6 @@ SOURCES += main.cpp\
     hardware_functions.cpp \
     aoscene.cpp \
     aomovie.cpp \
-    misc_functions.cpp \
     aocharmovie.cpp \
     aoemotebutton.cpp \
     emotes.cpp \
@@ -50,13 +49,34 @@ SOURCES += main.cpp\
     aoevidencedisplay.cpp \
     discord_rich_presence.cpp \
     aonotepad.cpp \
-    aobasshandle.cpp \
     aoexception.cpp \
     aoabstractplayer.cpp \
     aoshoutplayer.cpp \
     aonotearea.cpp \
     aonotepicker.cpp \
-    aolabel.cpp
+    aolabel.cpp \
+    aonameresolver.cpp \
+    aofilewriter.cpp \
+    aoassetindex.cpp \
+    aoassetresolver.cpp \
+    aoassetpack.cpp \
+    aoframecache.cpp \
+    aoanimationscanner.cpp \
+    aoviewport.cpp \
+    aoframeclock.cpp \
+    aoframeplayer.cpp \
+    aoscenecache.cpp \
+    aoframecontainer.cpp \
+    aolz4.cpp \
+    aoblit.cpp \
+    aomessagedisplay.cpp \
+    aoiclog.cpp \
+    aotranscriptwriter.cpp \
+    aochatarchive.cpp \
+    aochatsearch.cpp \
+    aosamplecache.cpp \
+    aoaudiomixer.cpp \
+    aoaudioengine.cpp
 
 HEADERS  += lobby.h \
     aoimage.h \
@@ -74,7 +94,6 @@ HEADERS  += lobby.h \
     hardware_functions.h \
     aoscene.h \
     aomovie.h \
-    misc_functions.h \
     aocharmovie.h \
     aoemotebutton.h \
     bass.h \
@@ -89,13 +108,34 @@ HEADERS  += lobby.h \
     discord_rich_presence.h \
     discord-rpc.h \
     aonotepad.h \
-    aobasshandle.hpp \
     aoexception.hpp \
     aoabstractplayer.hpp \
     aoshoutplayer.hpp \
     aonotearea.hpp \
     aonotepicker.hpp \
-    aolabel.hpp
+    aolabel.hpp \
+    aonameresolver.hpp \
+    aofilewriter.hpp \
+    aoassetindex.hpp \
+    aoassetresolver.hpp \
+    aoassetpack.hpp \
+    aoframecache.hpp \
+    aoanimationscanner.hpp \
+    aoviewport.hpp \
+    aoframeclock.hpp \
+    aoframeplayer.hpp \
+    aoscenecache.hpp \
+    aoframecontainer.hpp \
+    aolz4.hpp \
+    aoblit.hpp \
+    aomessagedisplay.hpp \
+    aoiclog.hpp \
+    aotranscriptwriter.hpp \
+    aochatarchive.hpp \
+    aochatsearch.hpp \
+    aosamplecache.hpp \
+    aoaudiomixer.hpp \
+    aoaudioengine.hpp
 
 # 1. You need to get BASS and put the x86 bass DLL/headers in the project root folder
 #    AND the compilation output folder. If you want a static link, you'll probably
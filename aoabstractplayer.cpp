@@ -1,7 +1,10 @@
 #include "aoabstractplayer.hpp"
 
+//players are only ever made on the GUI thread
+int AOAbstractPlayer::m_next_id = 1;
+
 AOAbstractPlayer::AOAbstractPlayer(QObject *p_parent, AOApplication *p_ao_app)
-  : QObject(p_parent), ao_app(p_ao_app)
+  : QObject(p_parent), ao_app(p_ao_app), m_id(m_next_id++)
 {}
 
 int AOAbstractPlayer::get_volume()
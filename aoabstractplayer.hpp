@@ -5,7 +5,6 @@
 #include <QString>
 
 #include "aoapplication.h"
-#include "aobasshandle.hpp"
 
 class AOAbstractPlayer : public QObject
 {
@@ -16,6 +15,9 @@ public:
 
   int get_volume();
 
+  //tells the sounds of this player apart from everyone else's in the audio engine
+  int get_id() {return m_id;}
+
 public slots:
   void set_volume(int p_volume);
 
@@ -29,6 +31,9 @@ protected:
 
 private:
   int m_volume = 0;
+  int m_id;
+
+  static int m_next_id;
 };
 
 #endif // AOABSTRACTPLAYER_HPP
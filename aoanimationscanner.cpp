@@ -0,0 +1,214 @@
+#include "aoanimationscanner.hpp"
+
+#include "aoassetindex.hpp"
+#include "file_functions.h"
+
+#include <QMutexLocker>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QtEndian>
+
+#include <cstring>
+
+AOAnimationScanner::AOAnimationScanner(QObject *p_parent) : QObject(p_parent)
+{
+}
+
+animation_info AOAnimationScanner::get_info(QString p_path)
+{
+  //the asset index only hears about files coming and going, not about edits in place
+  quint64 f_size;
+  qint64 f_time;
+  get_source_stamp(p_path, f_size, f_time);
+
+  {
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, cached_info>::const_iterator f_cached = m_infos.constFind(p_path);
+    if (f_cached != m_infos.constEnd() && f_cached->source_size == f_size && f_cached->source_time == f_time)
+      return f_cached->info;
+  }
+
+  cached_info f_cached;
+  f_cached.info = scan(read_asset(p_path));
+  f_cached.source_size = f_size;
+  f_cached.source_time = f_time;
+
+  QMutexLocker locker(&m_mutex);
+  m_infos.insert(p_path, f_cached);
+
+  return f_cached.info;
+}
+
+void AOAnimationScanner::get_source_stamp(QString p_path, quint64 &p_size, qint64 &p_time)
+{
+  QFileInfo f_info(p_path);
+
+  //only packed, the pack doesn't change under us
+  if (!f_info.exists())
+  {
+    p_size = 0;
+    p_time = 0;
+    return;
+  }
+
+  p_size = quint64(f_info.size());
+  p_time = f_info.lastModified().toMSecsSinceEpoch();
+}
+
+void AOAnimationScanner::invalidate()
+{
+  QMutexLocker locker(&m_mutex);
+  m_infos.clear();
+}
+
+void AOAnimationScanner::on_index_changed(QStringList p_changed)
+{
+  QMutexLocker locker(&m_mutex);
+
+  for (QHash<QString, cached_info>::iterator it = m_infos.begin() ; it != m_infos.end() ;)
+  {
+    if (AOAssetIndex::overlaps(it.key(), p_changed))
+      it = m_infos.erase(it);
+    else
+      ++it;
+  }
+}
+
+animation_info AOAnimationScanner::scan(const QByteArray &p_data)
+{
+  if (p_data.startsWith("GIF87a") || p_data.startsWith("GIF89a"))
+    return scan_gif(p_data);
+
+  if (p_data.startsWith("\x89PNG\r\n\x1a\n"))
+    return scan_png(p_data);
+
+  return animation_info();
+}
+
+animation_info AOAnimationScanner::scan_gif(const QByteArray &p_data)
+{
+  animation_info f_info;
+
+  const uchar *f_data = reinterpret_cast<const uchar*>(p_data.constData());
+  int f_size = p_data.size();
+
+  //header and logical screen descriptor
+  int f_pos = 13;
+  if (f_size < f_pos)
+    return f_info;
+
+  uchar f_screen_flags = f_data[10];
+  if (f_screen_flags & 0x80)
+    f_pos += 3 * (1 << ((f_screen_flags & 0x07) + 1));
+
+  int f_pending_delay = 0;
+
+  while (f_pos < f_size)
+  {
+    uchar f_block = f_data[f_pos++];
+
+    if (f_block == 0x3B)
+    {
+      //trailer
+      break;
+    }
+    else if (f_block == 0x21)
+    {
+      if (f_pos >= f_size)
+        return f_info;
+
+      uchar f_label = f_data[f_pos++];
+
+      //graphic control extension, holds the delay of the image after it in hundredths of a second
+      if (f_label == 0xF9 && f_pos + 5 < f_size && f_data[f_pos] >= 4)
+        f_pending_delay = (f_data[f_pos + 2] | (f_data[f_pos + 3] << 8)) * 10;
+    }
+    else if (f_block == 0x2C)
+    {
+      //image descriptor, then the lzw minimum code size
+      if (f_pos + 9 >= f_size)
+        return f_info;
+
+      uchar f_image_flags = f_data[f_pos + 8];
+      f_pos += 9;
+      if (f_image_flags & 0x80)
+        f_pos += 3 * (1 << ((f_image_flags & 0x07) + 1));
+      f_pos += 1;
+
+      f_info.delays.append(f_pending_delay);
+      f_pending_delay = 0;
+    }
+    else
+    {
+      //not a gif we know how to walk
+      return f_info;
+    }
+
+    //both extensions and image data end in a chain of sub-blocks, skip them
+    while (f_pos < f_size && f_data[f_pos] != 0)
+      f_pos += f_data[f_pos] + 1;
+    ++f_pos;
+  }
+
+  f_info.frame_count = f_info.delays.size();
+  for (int f_delay : f_info.delays)
+    f_info.duration += f_delay;
+
+  f_info.valid = f_info.frame_count > 0;
+  return f_info;
+}
+
+animation_info AOAnimationScanner::scan_png(const QByteArray &p_data)
+{
+  animation_info f_info;
+
+  const uchar *f_data = reinterpret_cast<const uchar*>(p_data.constData());
+  qint64 f_size = p_data.size();
+  qint64 f_pos = 8;
+
+  bool is_animated = false;
+
+  //chunks are length, type, data, crc
+  while (f_pos + 8 <= f_size)
+  {
+    quint32 f_length = qFromBigEndian<quint32>(f_data + f_pos);
+    const uchar *f_type = f_data + f_pos + 4;
+    const uchar *f_chunk = f_data + f_pos + 8;
+
+    if (f_pos + 12 + qint64(f_length) > f_size)
+      break;
+
+    if (memcmp(f_type, "acTL", 4) == 0)
+      is_animated = true;
+    else if (memcmp(f_type, "fcTL", 4) == 0 && f_length >= 26)
+    {
+      int f_delay_num = qFromBigEndian<quint16>(f_chunk + 20);
+      int f_delay_den = qFromBigEndian<quint16>(f_chunk + 22);
+
+      //a denominator of 0 means hundredths of a second
+      if (f_delay_den == 0)
+        f_delay_den = 100;
+
+      f_info.delays.append(f_delay_num * 1000 / f_delay_den);
+    }
+    else if (memcmp(f_type, "IEND", 4) == 0)
+      break;
+
+    f_pos += 12 + f_length;
+  }
+
+  //a plain png is a single frame that never moves on
+  if (!is_animated || f_info.delays.isEmpty())
+  {
+    f_info.delays.clear();
+    f_info.delays.append(0);
+  }
+
+  f_info.frame_count = f_info.delays.size();
+  for (int f_delay : f_info.delays)
+    f_info.duration += f_delay;
+
+  f_info.valid = true;
+  return f_info;
+}
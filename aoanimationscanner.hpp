@@ -0,0 +1,62 @@
+#ifndef AOANIMATIONSCANNER_HPP
+#define AOANIMATIONSCANNER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+
+struct animation_info
+{
+  //false if the file is missing or isn't a gif or png we understand
+  bool valid = false;
+  int frame_count = 0;
+  //the sum of all frame delays, in milliseconds
+  int duration = 0;
+  QVector<int> delays;
+};
+
+/**
+ * @brief The AOAnimationScanner reads frame counts and delays out of GIF and (A)PNG files.
+ * Only the container is walked, no pixel data gets decoded, so finding out how long a
+ * preanimation runs is nearly free. Results are cached per file, and a file whose size or
+ * modification time moved on since it was scanned is scanned again.
+ */
+
+class AOAnimationScanner : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOAnimationScanner(QObject *p_parent = nullptr);
+
+  animation_info get_info(QString p_path);
+
+public slots:
+  void invalidate();
+  //forgets the files under the paths the asset index reported
+  void on_index_changed(QStringList p_changed);
+
+private:
+  struct cached_info
+  {
+    animation_info info;
+    //what the file looked like when it was scanned, both 0 for files only in the pack
+    quint64 source_size = 0;
+    qint64 source_time = 0;
+  };
+
+  QMutex m_mutex;
+  QHash<QString, cached_info> m_infos;
+
+  static void get_source_stamp(QString p_path, quint64 &p_size, qint64 &p_time);
+
+  static animation_info scan(const QByteArray &p_data);
+  static animation_info scan_gif(const QByteArray &p_data);
+  static animation_info scan_png(const QByteArray &p_data);
+};
+
+#endif // AOANIMATIONSCANNER_HPP
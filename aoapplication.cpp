@@ -13,6 +13,27 @@ AOApplication::AOApplication(int &argc, char **argv) : QApplication(argc, argv)
 {
   net_manager = new NetworkManager(this);
   discord = new AttorneyOnline::Discord();
+  name_resolver = new AONameResolver(this);
+  file_writer = new AOFileWriter(this);
+  transcript_writer = new AOTranscriptWriter(get_base_path() + "logs/", this);
+  //optional, loose files under base/ take precedence over anything in it
+  asset_pack = new AOAssetPack(get_base_path());
+  asset_pack->open(get_base_path() + "base.aopk");
+  asset_index = new AOAssetIndex(get_base_path(), this);
+  asset_index->start_scan();
+  asset_resolver = new AOAssetResolver(this);
+  //every animation and the text reveal run off this
+  frame_clock = new AOFrameClock(this);
+  frame_cache = new AOFrameCache(this);
+  animation_scanner = new AOAnimationScanner(this);
+  //owns bass and everything playing on it, the players only post to it
+  audio_engine = new AOAudioEngine(this, this);
+  //files were added or removed somewhere under base/
+  QObject::connect(asset_index, SIGNAL(index_changed(QStringList)), asset_resolver, SLOT(on_index_changed(QStringList)));
+  QObject::connect(asset_index, SIGNAL(index_changed(QStringList)), frame_cache, SLOT(on_index_changed(QStringList)));
+  QObject::connect(asset_index, SIGNAL(index_changed(QStringList)), animation_scanner, SLOT(on_index_changed(QStringList)));
+  QObject::connect(asset_index, SIGNAL(index_changed(QStringList)), audio_engine, SLOT(on_index_changed(QStringList)));
+  QObject::connect(asset_index, SIGNAL(index_changed(QStringList)), name_resolver, SLOT(on_index_changed(QStringList)));
   QObject::connect(net_manager, SIGNAL(ms_connect_finished(bool, bool)),
                    SLOT(ms_connect_finished(bool, bool)));
 }
@@ -21,7 +42,13 @@ AOApplication::~AOApplication()
 {
   destruct_lobby();
   destruct_courtroom();
+  //the audio thread and its song opener still go through the pack, the index and the resolver,
+  //so it has to be gone before any of them. The courtroom's players post to it until here
+  delete audio_engine;
   delete discord;
+  //its decode threads may still be reading out of the pack
+  delete frame_cache;
+  delete asset_pack;
 }
 
 void AOApplication::construct_lobby()
@@ -97,6 +124,7 @@ QString AOApplication::get_version_string()
 void AOApplication::reload_theme()
 {
   current_theme = read_theme();
+  asset_resolver->invalidate();
 }
 
 void AOApplication::set_favorite_list()
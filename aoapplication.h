@@ -4,6 +4,16 @@
 #include "aopacket.h"
 #include "datatypes.h"
 #include "discord_rich_presence.h"
+#include "aonameresolver.hpp"
+#include "aofilewriter.hpp"
+#include "aotranscriptwriter.hpp"
+#include "aoassetindex.hpp"
+#include "aoassetresolver.hpp"
+#include "aoassetpack.hpp"
+#include "aoframeclock.hpp"
+#include "aoframecache.hpp"
+#include "aoanimationscanner.hpp"
+#include "aoaudioengine.hpp"
 
 #include <QApplication>
 #include <QVector>
@@ -25,6 +35,16 @@ public:
   Lobby *w_lobby;
   Courtroom *w_courtroom;
   AttorneyOnline::Discord *discord;
+  AONameResolver *name_resolver;
+  AOFileWriter *file_writer;
+  AOTranscriptWriter *transcript_writer;
+  AOAssetIndex *asset_index;
+  AOAssetResolver *asset_resolver;
+  AOAssetPack *asset_pack;
+  AOFrameClock *frame_clock;
+  AOFrameCache *frame_cache;
+  AOAnimationScanner *animation_scanner;
+  AOAudioEngine *audio_engine;
 
   bool lobby_constructed = false;
   bool courtroom_constructed = false;
@@ -140,13 +160,10 @@ public:
   //Appends the argument string to serverlist.txt
   void write_to_serverlist_txt(QString p_line);
 
-  //Writes to note file
+  //Queues a rewrite of the note file, it is written in the background
   void write_note(QString p_text, QString filename);
 
-  //appends to note file
-  void append_note(QString p_line, QString filename);
-
-  //Overwrites config.ini with new theme
+  //Queues an update of the theme in config.ini, it is written in the background
   void write_theme(QString theme);
 
 
@@ -186,12 +203,6 @@ public:
   //Returns the side of the p_char character from that characters ini file
   QString get_char_side(QString p_char);
 
-  //Returns the showname from the ini of p_char
-  QString get_showname(QString p_char);
-
-  //Returns showname from showname.ini
-  QString read_showname(QString p_char);
-
   //Returns the value of chat from the specific p_char's ini file
   QString get_chat(QString p_char);
 
@@ -0,0 +1,504 @@
+#include "aoassetindex.hpp"
+
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QMetaObject>
+#include <QRegExp>
+#include <QDebug>
+
+class AOAssetScanTask : public QRunnable
+{
+public:
+  AOAssetScanTask(AOAssetIndex *p_index) : m_index(p_index) {}
+
+  void run()
+  {
+    QHash<QString, AOAssetIndex::entry> f_entries;
+    QHash<QString, QStringList> f_children;
+    QStringList f_watch_candidates;
+
+    AOAssetIndex::scan_tree(m_index->m_root, "", f_entries, f_children, f_watch_candidates, &m_index->m_abort);
+
+    if (m_index->m_abort.load())
+      return;
+
+    {
+      QWriteLocker locker(&m_index->m_lock);
+      m_index->m_scanned_entries.swap(f_entries);
+      m_index->m_scanned_children.swap(f_children);
+      m_index->m_watch_candidates.swap(f_watch_candidates);
+    }
+
+    //the watchers have to be set up on the thread the index lives in
+    QMetaObject::invokeMethod(m_index, "on_scan_finished", Qt::QueuedConnection);
+  }
+
+private:
+  AOAssetIndex *m_index;
+};
+
+AOAssetIndex *AOAssetIndex::m_instance = nullptr;
+
+AOAssetIndex::AOAssetIndex(QString p_root, QObject *p_parent) : QObject(p_parent)
+{
+  m_root = p_root;
+  if (!m_root.endsWith("/"))
+    m_root += "/";
+
+  m_pool.setMaxThreadCount(1);
+
+  m_watcher = new QFileSystemWatcher(this);
+  connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(on_directory_changed(QString)));
+
+  m_instance = this;
+}
+
+AOAssetIndex::~AOAssetIndex()
+{
+  if (m_instance == this)
+    m_instance = nullptr;
+
+  m_abort.store(1);
+  m_pool.waitForDone();
+}
+
+AOAssetIndex *AOAssetIndex::instance()
+{
+  return m_instance;
+}
+
+void AOAssetIndex::start_scan()
+{
+  m_scan_started = QDateTime::currentDateTimeUtc();
+  m_pool.start(new AOAssetScanTask(this));
+}
+
+bool AOAssetIndex::is_ready()
+{
+  QReadLocker locker(&m_lock);
+  return m_ready;
+}
+
+bool AOAssetIndex::lookup_file(QString p_path, bool &p_exists)
+{
+  QReadLocker locker(&m_lock);
+  return find_locked(p_path, false, p_exists);
+}
+
+bool AOAssetIndex::lookup_dir(QString p_path, bool &p_exists)
+{
+  QReadLocker locker(&m_lock);
+  return find_locked(p_path, true, p_exists);
+}
+
+QString AOAssetIndex::get_real_path(QString p_path)
+{
+  QReadLocker locker(&m_lock);
+
+  QString f_key;
+  QString f_relative;
+
+  if (!m_ready || !get_key(p_path, f_key, f_relative) || f_key.isEmpty())
+    return p_path;
+
+  QHash<QString, entry>::const_iterator f_entry = m_entries.constFind(f_key);
+  if (f_entry == m_entries.constEnd())
+    return p_path;
+
+  return m_root + f_entry.value().actual;
+}
+
+bool AOAssetIndex::get_key(QString p_path, QString &p_key, QString &p_relative)
+{
+  if (!p_path.startsWith(m_root))
+    return false;
+
+  QString f_relative = p_path.mid(m_root.size());
+  f_relative.replace("\\", "/");
+
+  //paths like "characters/phoenix/../../misc/blank" show up every now and then
+  if (f_relative.contains("//") || f_relative.contains("./"))
+    f_relative = QDir::cleanPath(f_relative);
+
+  while (f_relative.endsWith("/"))
+    f_relative.chop(1);
+
+  if (f_relative == ".")
+    f_relative = "";
+  else if (f_relative.startsWith(".."))
+    return false;
+
+  p_relative = f_relative;
+  p_key = f_relative.toLower();
+  return true;
+}
+
+bool AOAssetIndex::find_locked(QString p_path, bool p_dir, bool &p_exists)
+{
+  if (!m_ready)
+    return false;
+
+  QString f_key;
+  QString f_relative;
+
+  if (!get_key(p_path, f_key, f_relative))
+    return false;
+
+  if (f_key.isEmpty())
+  {
+    p_exists = p_dir;
+    return true;
+  }
+
+  //never indexed
+  if (is_ignored(f_relative, p_dir) || m_ignored.contains(f_key))
+    return false;
+
+  //we would never hear about changes to this directory, so the disk has to answer
+  if (!m_watched.contains(parent_key(f_key)))
+    return false;
+
+  QHash<QString, entry>::const_iterator f_entry = m_entries.constFind(f_key);
+
+#if !defined(Q_OS_WIN) && !defined(Q_OS_MAC)
+  //the hash is case-folded but this filesystem is not, and only one casing is kept per key.
+  //A sibling that only differs in case may be the one indexed, so the disk has to answer
+  if (f_entry != m_entries.constEnd() && f_entry.value().actual != f_relative)
+    return false;
+#endif
+
+  p_exists = f_entry != m_entries.constEnd() && f_entry.value().is_dir == p_dir;
+
+  m_hits.ref();
+  return true;
+}
+
+void AOAssetIndex::ignore_file(QString p_path)
+{
+  QString f_key;
+  QString f_relative;
+
+  if (!get_key(p_path, f_key, f_relative) || f_key.isEmpty())
+    return;
+
+  {
+    QReadLocker locker(&m_lock);
+    if (m_ignored.contains(f_key))
+      return;
+  }
+
+  QWriteLocker locker(&m_lock);
+
+  m_ignored.insert(f_key);
+
+  //the index may have found it before we knew it was ours
+  QStringList f_removed;
+  remove_entry_locked(f_key, f_removed);
+}
+
+bool AOAssetIndex::overlaps(QString p_path, const QStringList &p_changed)
+{
+  for (const QString &f_changed : p_changed)
+  {
+    if (p_path.startsWith(f_changed, Qt::CaseInsensitive) || f_changed.startsWith(p_path, Qt::CaseInsensitive))
+      return true;
+  }
+
+  return false;
+}
+
+bool AOAssetIndex::is_ignored(QString p_relative, bool p_is_dir)
+{
+  QString f_top = p_relative.section("/", 0, 0).toLower();
+
+  //the transcripts, their archives, and the notepad and favorites configs
+  if (f_top == "logs" || f_top == "configs")
+    return true;
+
+  //config.ini, serverlist.txt and the like
+  if (!p_is_dir && !p_relative.contains("/"))
+    return true;
+
+  //QSaveFile writes "<name>.<ext>.XXXXXX" and renames it over the real file
+  static const QRegExp save_file_temp("^.+\\.[^./]+\\.[A-Za-z0-9]{6}$");
+  return !p_is_dir && save_file_temp.exactMatch(p_relative.section("/", -1));
+}
+
+QString AOAssetIndex::parent_key(QString p_key)
+{
+  int f_slash = p_key.lastIndexOf("/");
+
+  if (f_slash < 0)
+    return "";
+
+  return p_key.left(f_slash);
+}
+
+void AOAssetIndex::insert_entry(QHash<QString, entry> &p_entries, QHash<QString, QStringList> &p_children,
+                                QString p_relative, bool p_is_dir)
+{
+  QString f_key = p_relative.toLower();
+
+  //two names that only differ in case, the first one wins. find_locked sends lookups for the
+  //other one to the disk
+  if (p_entries.contains(f_key))
+    return;
+
+  entry f_entry;
+  f_entry.actual = p_relative;
+  f_entry.is_dir = p_is_dir;
+  p_entries.insert(f_key, f_entry);
+
+  p_children[parent_key(f_key)].append(f_key);
+}
+
+void AOAssetIndex::scan_tree(QString p_root, QString p_relative, QHash<QString, entry> &p_entries,
+                             QHash<QString, QStringList> &p_children, QStringList &p_watch_candidates,
+                             QAtomicInt *p_abort)
+{
+  QString f_start;
+
+  if (p_relative.isEmpty())
+  {
+    f_start = p_root.left(p_root.size() - 1);
+    p_watch_candidates.append("");
+  }
+  else
+  {
+    f_start = p_root + p_relative;
+    if (p_relative.count("/") < max_watch_depth)
+      p_watch_candidates.append(p_relative.toLower());
+  }
+
+  QDirIterator it(f_start, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                  QDirIterator::Subdirectories);
+
+  while (it.hasNext())
+  {
+    if (p_abort != nullptr && p_abort->load())
+      return;
+
+    QString f_relative = it.next().mid(p_root.size());
+    bool is_dir = it.fileInfo().isDir();
+
+    if (is_ignored(f_relative, is_dir))
+      continue;
+
+    insert_entry(p_entries, p_children, f_relative, is_dir);
+
+    if (is_dir && f_relative.count("/") < max_watch_depth)
+      p_watch_candidates.append(f_relative.toLower());
+  }
+}
+
+void AOAssetIndex::watch_directories(QStringList p_keys)
+{
+  QStringList f_paths;
+  QStringList f_keys;
+
+  for (QString f_key : p_keys)
+  {
+    if (m_watched.size() + f_paths.size() >= max_watched_dirs)
+    {
+      qDebug() << "W: asset index is at its watch limit, the rest of base/ is checked on the disk";
+      break;
+    }
+
+    if (f_key.isEmpty())
+      f_paths.append(m_root);
+    else
+      f_paths.append(m_root + m_entries.value(f_key).actual);
+
+    f_keys.append(f_key);
+  }
+
+  if (f_paths.isEmpty())
+    return;
+
+  QStringList f_failed = m_watcher->addPaths(f_paths);
+
+  QWriteLocker locker(&m_lock);
+
+  for (int n_path = 0 ; n_path < f_paths.size() ; ++n_path)
+  {
+    if (!f_failed.contains(f_paths.at(n_path)))
+      m_watched.insert(f_keys.at(n_path));
+  }
+
+  if (!f_failed.isEmpty())
+    qDebug() << "W: could not watch" << f_failed.size() << "asset directories";
+}
+
+void AOAssetIndex::remove_entry_locked(QString p_key, QStringList &p_removed)
+{
+  QHash<QString, entry>::iterator f_entry = m_entries.find(p_key);
+  if (f_entry == m_entries.end())
+    return;
+
+  bool is_dir = f_entry.value().is_dir;
+  QString f_actual = f_entry.value().actual;
+
+  m_entries.erase(f_entry);
+  m_children[parent_key(p_key)].removeOne(p_key);
+
+  p_removed.append(m_root + f_actual + (is_dir ? "/" : ""));
+
+  if (!is_dir)
+    return;
+
+  //the directory's own path above already covers everything in it
+  QStringList f_children = m_children.take(p_key);
+  QStringList f_ignored;
+  for (QString f_child : f_children)
+    remove_entry_locked(f_child, f_ignored);
+
+  if (m_watched.remove(p_key))
+    m_watcher->removePath(m_root + f_actual);
+}
+
+QStringList AOAssetIndex::rescan_directory(QString p_key)
+{
+  QString f_prefix;
+  QStringList f_changed;
+
+  if (!p_key.isEmpty())
+    f_prefix = m_entries.value(p_key).actual + "/";
+
+  QDir f_dir(m_root + f_prefix);
+
+  QWriteLocker locker(&m_lock);
+
+  if (!p_key.isEmpty() && !f_dir.exists())
+  {
+    remove_entry_locked(p_key, f_changed);
+    return f_changed;
+  }
+
+  QFileInfoList f_infos = f_dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden);
+  QSet<QString> f_current;
+  QStringList f_new_dirs;
+
+  for (QFileInfo f_info : f_infos)
+  {
+    QString f_relative = f_prefix + f_info.fileName();
+
+    QString f_key = f_relative.toLower();
+
+    if (is_ignored(f_relative, f_info.isDir()) || m_ignored.contains(f_key))
+      continue;
+
+    QString f_suffix = f_info.isDir() ? "/" : "";
+    f_current.insert(f_key);
+
+    QHash<QString, entry>::iterator f_entry = m_entries.find(f_key);
+
+    if (f_entry != m_entries.end() && f_entry.value().is_dir == f_info.isDir())
+    {
+      //it may have been renamed to a different case
+      if (f_entry.value().actual != f_relative)
+      {
+        f_changed.append(m_root + f_entry.value().actual + f_suffix);
+        f_changed.append(m_root + f_relative + f_suffix);
+        f_entry.value().actual = f_relative;
+      }
+      continue;
+    }
+
+    if (f_entry != m_entries.end())
+      remove_entry_locked(f_key, f_changed);
+
+    insert_entry(m_entries, m_children, f_relative, f_info.isDir());
+    f_changed.append(m_root + f_relative + f_suffix);
+
+    if (f_info.isDir())
+      f_new_dirs.append(f_relative);
+  }
+
+  QStringList f_old_children = m_children.value(p_key);
+  for (QString f_child : f_old_children)
+  {
+    if (!f_current.contains(f_child))
+      remove_entry_locked(f_child, f_changed);
+  }
+
+  //a new character folder or the like, index everything in it
+  QStringList f_watch_candidates;
+  for (QString f_relative : f_new_dirs)
+    scan_tree(m_root, f_relative, m_entries, m_children, f_watch_candidates, nullptr);
+
+  locker.unlock();
+
+  watch_directories(f_watch_candidates);
+
+  return f_changed;
+}
+
+void AOAssetIndex::on_scan_finished()
+{
+  QStringList f_watch_candidates;
+
+  {
+    QWriteLocker locker(&m_lock);
+    m_entries.swap(m_scanned_entries);
+    m_children.swap(m_scanned_children);
+    f_watch_candidates.swap(m_watch_candidates);
+    m_scanned_entries.clear();
+    m_scanned_children.clear();
+
+    //the scan didn't know about these yet
+    QStringList f_removed;
+    for (QString f_key : m_ignored)
+      remove_entry_locked(f_key, f_removed);
+  }
+
+  watch_directories(f_watch_candidates);
+
+  //files added or removed while the scan ran came before the watchers did. Adding or removing
+  //an entry touches its directory, the slack is for file systems with coarse timestamps
+  QDateTime f_since = m_scan_started.addSecs(-2);
+
+  for (QString f_key : f_watch_candidates)
+  {
+    //not watched, or gone with a directory rescanned before it
+    if (!m_watched.contains(f_key))
+      continue;
+
+    QString f_path = f_key.isEmpty() ? m_root : m_root + m_entries.value(f_key).actual;
+    if (QFileInfo(f_path).lastModified().toUTC() >= f_since)
+      rescan_directory(f_key);
+  }
+
+  {
+    QWriteLocker locker(&m_lock);
+    m_ready = true;
+  }
+
+  qDebug() << "asset index ready:" << m_entries.size() << "entries," << m_watched.size() << "directories watched";
+
+  emit index_changed(QStringList{m_root});
+}
+
+void AOAssetIndex::on_directory_changed(QString p_path)
+{
+  QString f_path = p_path;
+  if (!f_path.endsWith("/"))
+    f_path += "/";
+
+  QString f_key;
+  QString f_relative;
+
+  if (!get_key(f_path, f_key, f_relative))
+    return;
+
+  QStringList f_changed = rescan_directory(f_key);
+
+  //a note or a config saved next to the assets, a temporary file that came and went
+  if (f_changed.isEmpty())
+    return;
+
+  emit index_changed(f_changed);
+}
@@ -0,0 +1,132 @@
+#ifndef AOASSETINDEX_HPP
+#define AOASSETINDEX_HPP
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QDateTime>
+#include <QReadWriteLock>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QFileSystemWatcher>
+
+class AOAssetScanTask;
+
+/**
+ * @brief The AOAssetIndex knows which files exist under base/ without asking the disk.
+ * The tree is scanned once on a background thread into a case-folded hash table and
+ * kept fresh by directory watchers. Lookups for paths in directories that aren't
+ * watched (too deep, or the watch limit was hit) are left to the caller, who falls
+ * back to asking the filesystem. What the client writes itself (logs/, configs/, the
+ * files right in base/ and the temporary files of a QSaveFile) is left out entirely,
+ * so saving a note or a config doesn't look like the assets changed.
+ */
+
+class AOAssetIndex : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOAssetIndex(QString p_root, QObject *p_parent = nullptr);
+  ~AOAssetIndex();
+
+  //Returns the index used by file_exists and dir_exists, or nullptr if there is none
+  static AOAssetIndex *instance();
+
+  //Starts scanning the root directory in the background. Lookups fail until it's done
+  void start_scan();
+
+  bool is_ready();
+
+  //Returns false if the index can't answer for p_path, otherwise sets p_exists
+  bool lookup_file(QString p_path, bool &p_exists);
+  bool lookup_dir(QString p_path, bool &p_exists);
+
+  //Returns p_path with the casing it has on the disk, or p_path itself if it isn't indexed
+  QString get_real_path(QString p_path);
+
+  //Returns how many lookups the index has answered without touching the disk
+  int get_hit_count() {return m_hits.load();}
+
+  //Leaves p_path out of the index from now on. For files the client writes itself that may
+  //sit anywhere under the root, like note files
+  void ignore_file(QString p_path);
+
+  //Returns true if p_path lies in or contains one of the paths index_changed() reported.
+  //Directories in both end with a slash
+  static bool overlaps(QString p_path, const QStringList &p_changed);
+
+  //only this many directory levels below the root get a watcher
+  static const int max_watch_depth = 3;
+  //some platforms get very unhappy with too many watched directories
+  static const int max_watched_dirs = 4000;
+
+  struct entry
+  {
+    QString actual;
+    bool is_dir = false;
+  };
+
+signals:
+  //emitted on the GUI thread whenever the contents of the index changed. p_changed holds the
+  //absolute paths of what was added, removed or renamed, directories with a trailing slash.
+  //It's just the root after a full scan
+  void index_changed(QStringList p_changed);
+
+private:
+  static AOAssetIndex *m_instance;
+
+  QString m_root;
+
+  QReadWriteLock m_lock;
+  bool m_ready = false;
+
+  //folded relative path -> entry
+  QHash<QString, entry> m_entries;
+  //folded relative directory path -> folded relative paths of its direct children
+  QHash<QString, QStringList> m_children;
+  //folded relative paths of the directories we get notified about
+  QSet<QString> m_watched;
+  //keys handed to ignore_file()
+  QSet<QString> m_ignored;
+
+  QFileSystemWatcher *m_watcher;
+
+  QAtomicInt m_hits;
+  QAtomicInt m_abort;
+  QThreadPool m_pool;
+
+  //results of the background scan, handed over in on_scan_finished
+  QHash<QString, entry> m_scanned_entries;
+  QHash<QString, QStringList> m_scanned_children;
+  QStringList m_watch_candidates;
+  //directories touched after this were changed while nobody watched them, see on_scan_finished
+  QDateTime m_scan_started;
+
+  bool get_key(QString p_path, QString &p_key, QString &p_relative);
+  bool find_locked(QString p_path, bool p_dir, bool &p_exists);
+
+  //returns the absolute paths of what changed, see index_changed()
+  QStringList rescan_directory(QString p_key);
+  void remove_entry_locked(QString p_key, QStringList &p_removed);
+  void watch_directories(QStringList p_keys);
+
+  static QString parent_key(QString p_key);
+  //true for whatever the client writes itself, see the class comment
+  static bool is_ignored(QString p_relative, bool p_is_dir);
+  static void insert_entry(QHash<QString, entry> &p_entries, QHash<QString, QStringList> &p_children,
+                           QString p_relative, bool p_is_dir);
+  static void scan_tree(QString p_root, QString p_relative, QHash<QString, entry> &p_entries,
+                        QHash<QString, QStringList> &p_children, QStringList &p_watch_candidates,
+                        QAtomicInt *p_abort);
+
+  friend class AOAssetScanTask;
+
+private slots:
+  void on_scan_finished();
+  void on_directory_changed(QString p_path);
+};
+
+#endif // AOASSETINDEX_HPP
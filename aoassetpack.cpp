@@ -0,0 +1,193 @@
+#include "aoassetpack.hpp"
+
+#include <QDir>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+
+AOAssetPack *AOAssetPack::m_instance = nullptr;
+
+AOAssetPack::AOAssetPack(QString p_root)
+{
+  m_root = p_root;
+  if (!m_root.endsWith("/"))
+    m_root += "/";
+
+  m_instance = this;
+}
+
+AOAssetPack::~AOAssetPack()
+{
+  if (m_instance == this)
+    m_instance = nullptr;
+
+  close();
+}
+
+AOAssetPack *AOAssetPack::instance()
+{
+  return m_instance;
+}
+
+bool AOAssetPack::open(QString p_file)
+{
+  close();
+
+  m_file.setFileName(p_file);
+
+  if (!m_file.open(QIODevice::ReadOnly))
+    return false;
+
+  m_size = m_file.size();
+  const uchar *f_data = m_size >= header_size ? m_file.map(0, m_size) : nullptr;
+
+  if (f_data == nullptr || memcmp(f_data, "AOPK", 4) != 0 ||
+      qFromLittleEndian<quint32>(f_data + 4) != pack_version)
+  {
+    qDebug() << "W:" << p_file << "is not a usable asset pack";
+    m_file.close();
+    return false;
+  }
+
+  m_entry_count = qFromLittleEndian<quint32>(f_data + 8);
+  m_bucket_count = qFromLittleEndian<quint32>(f_data + 12);
+  quint64 f_buckets_offset = qFromLittleEndian<quint64>(f_data + 16);
+  quint64 f_entries_offset = qFromLittleEndian<quint64>(f_data + 24);
+  quint64 f_names_offset = qFromLittleEndian<quint64>(f_data + 32);
+
+  //the bucket count is a power of two so the probe can mask instead of divide
+  bool f_valid = m_bucket_count > 0 && (m_bucket_count & (m_bucket_count - 1)) == 0 &&
+      m_bucket_count > m_entry_count &&
+      f_buckets_offset + quint64(m_bucket_count) * 4 <= quint64(m_size) &&
+      f_entries_offset + quint64(m_entry_count) * entry_size <= quint64(m_size) &&
+      f_names_offset <= f_entries_offset;
+
+  if (!f_valid)
+  {
+    qDebug() << "W:" << p_file << "has a broken index";
+    m_file.unmap(const_cast<uchar*>(f_data));
+    m_file.close();
+    return false;
+  }
+
+  m_data = f_data;
+  m_buckets = m_data + f_buckets_offset;
+  m_entries = m_data + f_entries_offset;
+  m_names = m_data + f_names_offset;
+  m_names_size = f_entries_offset - f_names_offset;
+
+  qDebug() << "asset pack" << p_file << "opened with" << m_entry_count << "entries";
+
+  return true;
+}
+
+void AOAssetPack::close()
+{
+  if (m_data != nullptr)
+    m_file.unmap(const_cast<uchar*>(m_data));
+
+  m_file.close();
+
+  m_data = nullptr;
+  m_size = 0;
+  m_entry_count = 0;
+  m_bucket_count = 0;
+}
+
+bool AOAssetPack::contains_file(QString p_path)
+{
+  int f_entry = find(p_path);
+
+  return f_entry >= 0 && !(qFromLittleEndian<quint32>(m_entries + f_entry * entry_size + 4) & DIRECTORY);
+}
+
+bool AOAssetPack::contains_dir(QString p_path)
+{
+  int f_entry = find(p_path);
+
+  return f_entry >= 0 && (qFromLittleEndian<quint32>(m_entries + f_entry * entry_size + 4) & DIRECTORY);
+}
+
+QByteArray AOAssetPack::read(QString p_path)
+{
+  int f_entry = find(p_path);
+  if (f_entry < 0)
+    return QByteArray();
+
+  const uchar *f_record = m_entries + f_entry * entry_size;
+  quint32 f_flags = qFromLittleEndian<quint32>(f_record + 4);
+  quint64 f_offset = qFromLittleEndian<quint64>(f_record + 16);
+  quint32 f_stored_size = qFromLittleEndian<quint32>(f_record + 24);
+
+  if ((f_flags & DIRECTORY) || f_offset + f_stored_size > quint64(m_size))
+    return QByteArray();
+
+  QByteArray f_stored = QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + f_offset), f_stored_size);
+
+  if (f_flags & COMPRESSED)
+    return qUncompress(f_stored);
+
+  return f_stored;
+}
+
+QString AOAssetPack::get_key(QString p_relative)
+{
+  QString f_key = p_relative;
+  f_key.replace("\\", "/");
+
+  if (f_key.contains("//") || f_key.contains("./"))
+    f_key = QDir::cleanPath(f_key);
+
+  while (f_key.endsWith("/"))
+    f_key.chop(1);
+
+  return f_key.toLower();
+}
+
+quint32 AOAssetPack::hash_key(const QByteArray &p_key)
+{
+  //FNV-1a
+  quint32 f_hash = 2166136261u;
+
+  for (char f_byte : p_key)
+  {
+    f_hash ^= static_cast<uchar>(f_byte);
+    f_hash *= 16777619u;
+  }
+
+  return f_hash;
+}
+
+int AOAssetPack::find(QString p_path)
+{
+  if (m_data == nullptr || !p_path.startsWith(m_root))
+    return -1;
+
+  QByteArray f_key = get_key(p_path.mid(m_root.size())).toUtf8();
+  quint32 f_hash = hash_key(f_key);
+  quint32 f_mask = m_bucket_count - 1;
+
+  for (quint32 n_probe = 0 ; n_probe < m_bucket_count ; ++n_probe)
+  {
+    quint32 f_slot = (f_hash + n_probe) & f_mask;
+    quint32 f_index = qFromLittleEndian<quint32>(m_buckets + f_slot * 4);
+
+    if (f_index == 0 || f_index > m_entry_count)
+      return -1;
+
+    const uchar *f_record = m_entries + (f_index - 1) * entry_size;
+
+    if (qFromLittleEndian<quint32>(f_record) != f_hash)
+      continue;
+
+    quint32 f_name_offset = qFromLittleEndian<quint32>(f_record + 8);
+    quint32 f_name_size = qFromLittleEndian<quint32>(f_record + 12);
+
+    if (f_name_size == quint32(f_key.size()) && quint64(f_name_offset) + f_name_size <= quint64(m_names_size) &&
+        memcmp(m_names + f_name_offset, f_key.constData(), f_name_size) == 0)
+      return f_index - 1;
+  }
+
+  return -1;
+}
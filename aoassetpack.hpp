@@ -0,0 +1,79 @@
+#ifndef AOASSETPACK_HPP
+#define AOASSETPACK_HPP
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+
+/**
+ * @brief The AOAssetPack reads base/ out of a single indexed pack file.
+ * The pack is memory-mapped when it is opened. Paths are found through an open-addressing
+ * hash table stored in the file, so looking one up never touches the disk. Entries can be
+ * stored as they are or compressed with qCompress. Loose files under base/ always win over
+ * packed ones, see file_functions.cpp.
+ *
+ * Layout, all integers little-endian:
+ *   header   magic "AOPK", version, entry count, bucket count,
+ *            offsets of the buckets, the entry table and the names
+ *   data     the contents of every entry, back to back
+ *   names    the case-folded relative paths, UTF-8
+ *   entries  hash, flags, name offset, name size, data offset, stored size, real size
+ *   buckets  entry index + 1 per slot, 0 for an empty slot
+ */
+
+class AOAssetPack
+{
+public:
+  AOAssetPack(QString p_root);
+  ~AOAssetPack();
+
+  //Returns the pack used by file_functions.cpp, or nullptr if there is none
+  static AOAssetPack *instance();
+
+  //Maps p_file into memory. Returns false if it's missing or malformed
+  bool open(QString p_file);
+  void close();
+  bool is_open() {return m_data != nullptr;}
+
+  //p_path is a full path below the root passed to the constructor
+  bool contains_file(QString p_path);
+  bool contains_dir(QString p_path);
+
+  //Returns the contents of p_path. Stored entries point straight into the mapped file
+  QByteArray read(QString p_path);
+
+  //Turns a path relative to the packed directory into the key it is stored under
+  static QString get_key(QString p_relative);
+  static quint32 hash_key(const QByteArray &p_key);
+
+  static const quint32 pack_version = 1;
+  static const int header_size = 40;
+  static const int entry_size = 32;
+
+  enum entry_flag
+  {
+    COMPRESSED = 1,
+    DIRECTORY = 2
+  };
+
+private:
+  static AOAssetPack *m_instance;
+
+  QString m_root;
+
+  QFile m_file;
+  const uchar *m_data = nullptr;
+  qint64 m_size = 0;
+
+  quint32 m_entry_count = 0;
+  quint32 m_bucket_count = 0;
+  const uchar *m_buckets = nullptr;
+  const uchar *m_entries = nullptr;
+  const uchar *m_names = nullptr;
+  qint64 m_names_size = 0;
+
+  //Returns the index of the entry for p_path, or -1
+  int find(QString p_path);
+};
+
+#endif // AOASSETPACK_HPP
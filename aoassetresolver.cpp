@@ -0,0 +1,205 @@
+#include "aoassetresolver.hpp"
+
+#include "aoapplication.h"
+#include "aoassetindex.hpp"
+#include "file_functions.h"
+
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QSet>
+
+//a miss the index answered for can be kept, the index tells us when the file shows up
+static bool is_indexed(QString p_path)
+{
+  AOAssetIndex *f_index = AOAssetIndex::instance();
+  bool f_exists = false;
+
+  return f_index != nullptr && f_index->lookup_file(p_path, f_exists);
+}
+
+AOAssetResolver::AOAssetResolver(AOApplication *p_ao_app)
+  : QObject(p_ao_app), ao_app(p_ao_app)
+{
+  get_ext_set({""});
+}
+
+int AOAssetResolver::get_layer_set(QStringList p_layers)
+{
+  {
+    QReadLocker locker(&m_lock);
+
+    QHash<QStringList, int>::const_iterator f_id = m_layer_set_ids.constFind(p_layers);
+    if (f_id != m_layer_set_ids.constEnd())
+      return f_id.value();
+  }
+
+  QWriteLocker locker(&m_lock);
+
+  //someone else may have added it in the meantime
+  if (m_layer_set_ids.contains(p_layers))
+    return m_layer_set_ids.value(p_layers);
+
+  m_layer_sets.append(p_layers);
+  m_layer_set_ids.insert(p_layers, m_layer_sets.size() - 1);
+
+  return m_layer_sets.size() - 1;
+}
+
+int AOAssetResolver::get_ext_set(QVector<QString> p_exts)
+{
+  {
+    QReadLocker locker(&m_lock);
+
+    QHash<QVector<QString>, int>::const_iterator f_id = m_ext_set_ids.constFind(p_exts);
+    if (f_id != m_ext_set_ids.constEnd())
+      return f_id.value();
+  }
+
+  QWriteLocker locker(&m_lock);
+
+  if (m_ext_set_ids.contains(p_exts))
+    return m_ext_set_ids.value(p_exts);
+
+  m_ext_sets.append(p_exts);
+  m_ext_set_ids.insert(p_exts, m_ext_sets.size() - 1);
+
+  return m_ext_sets.size() - 1;
+}
+
+QString AOAssetResolver::resolve(QStringList p_layers, QString p_name, QVector<QString> p_exts)
+{
+  return resolve(get_layer_set(p_layers), p_name, get_ext_set(p_exts));
+}
+
+QString AOAssetResolver::resolve(int p_layer_set, QString p_name, int p_ext_set)
+{
+  resolve_key f_key = {p_layer_set, p_ext_set, p_name};
+
+  QStringList f_layers;
+  QVector<QString> f_exts;
+  int f_generation;
+
+  {
+    QReadLocker locker(&m_lock);
+
+    QHash<resolve_key, QString>::const_iterator f_cached = m_resolved.constFind(f_key);
+    if (f_cached != m_resolved.constEnd())
+      return f_cached.value();
+
+    f_layers = m_layer_sets.value(p_layer_set);
+    f_exts = m_ext_sets.value(p_ext_set);
+    f_generation = m_generation;
+  }
+
+  QString f_result = "";
+  bool is_cacheable = true;
+
+  for (QString f_layer : f_layers)
+  {
+    QString f_layer_path = get_layer_path(f_layer);
+    if (f_layer_path == "")
+      continue;
+
+    for (QString f_ext : f_exts)
+    {
+      QString f_path = f_layer_path + p_name + f_ext;
+
+      if (file_exists(f_path))
+      {
+        f_result = f_path;
+        break;
+      }
+
+      //the disk had to answer, it may be there next time
+      if (!is_indexed(f_path))
+        is_cacheable = false;
+    }
+
+    if (f_result != "")
+      break;
+  }
+
+  if (f_result == "" && !is_cacheable)
+    return f_result;
+
+  QWriteLocker locker(&m_lock);
+
+  if (f_generation == m_generation)
+    m_resolved.insert(f_key, f_result);
+
+  return f_result;
+}
+
+QString AOAssetResolver::get_layer_path(QString p_layer)
+{
+  {
+    QReadLocker locker(&m_lock);
+
+    QHash<QString, QString>::const_iterator f_cached = m_layer_paths.constFind(p_layer);
+    if (f_cached != m_layer_paths.constEnd())
+      return f_cached.value();
+  }
+
+  QString f_type = p_layer.section(":", 0, 0);
+  QString f_arg = p_layer.section(":", 1);
+  QString f_path = "";
+
+  if (f_type == "character" && f_arg != "")
+    f_path = ao_app->get_character_path(f_arg);
+  else if (f_type == "theme")
+    f_path = ao_app->get_theme_path();
+  else if (f_type == "default_theme")
+    f_path = ao_app->get_default_theme_path();
+  else if (f_type == "custom_theme" && f_arg != "")
+    f_path = ao_app->get_base_path() + "themes/" + f_arg + "/";
+  else if (f_type == "demothings")
+    f_path = ao_app->get_demothings_path();
+
+  QWriteLocker locker(&m_lock);
+  m_layer_paths.insert(p_layer, f_path);
+
+  return f_path;
+}
+
+void AOAssetResolver::invalidate()
+{
+  QWriteLocker locker(&m_lock);
+
+  ++m_generation;
+  m_resolved.clear();
+  m_layer_paths.clear();
+}
+
+void AOAssetResolver::on_index_changed(QStringList p_changed)
+{
+  QWriteLocker locker(&m_lock);
+
+  ++m_generation;
+
+  //the layer paths only depend on the settings, they stay
+  QSet<int> f_affected;
+
+  for (int n_set = 0 ; n_set < m_layer_sets.size() ; ++n_set)
+  {
+    for (QString f_layer : m_layer_sets.at(n_set))
+    {
+      QString f_layer_path = m_layer_paths.value(f_layer);
+      if (f_layer_path != "" && AOAssetIndex::overlaps(f_layer_path, p_changed))
+      {
+        f_affected.insert(n_set);
+        break;
+      }
+    }
+  }
+
+  if (f_affected.isEmpty())
+    return;
+
+  for (QHash<resolve_key, QString>::iterator it = m_resolved.begin() ; it != m_resolved.end() ;)
+  {
+    if (f_affected.contains(it.key().layer_set))
+      it = m_resolved.erase(it);
+    else
+      ++it;
+  }
+}
@@ -0,0 +1,91 @@
+#ifndef AOASSETRESOLVER_HPP
+#define AOASSETRESOLVER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QReadWriteLock>
+
+class AOApplication;
+
+/**
+ * @brief The AOAssetResolver finds the file behind a logical asset name.
+ * It is given the name and an ordered list of layers to look in, and it returns the first
+ * layer that has the file. Results are remembered per (layers, name, extensions) until the
+ * theme, the character or the files in those layers change. Layer lists and extension lists
+ * are turned into ids once, so a lookup that was seen before is a single hash lookup.
+ * Misses are only remembered if the asset index answered for them, it's the one that hears
+ * about the file showing up later.
+ *
+ * Layers are written as
+ *   "character:<name>"     base/characters/<name>/
+ *   "theme"                the current theme
+ *   "default_theme"        base/themes/default/
+ *   "custom_theme:<name>"  base/themes/<name>/
+ *   "demothings"           the roster image folder
+ */
+
+class AOAssetResolver : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOAssetResolver(AOApplication *p_ao_app);
+
+  //Returns the id of p_layers for resolve(), fetch it once for a batch of names
+  int get_layer_set(QStringList p_layers);
+  //Returns the id of p_exts for resolve(). 0 is {""}, the name as it is
+  int get_ext_set(QVector<QString> p_exts);
+
+  //Returns the path of the first p_name + extension found in the layers, or the empty string
+  QString resolve(int p_layer_set, QString p_name, int p_ext_set = 0);
+  QString resolve(QStringList p_layers, QString p_name, QVector<QString> p_exts = {""});
+
+  //Returns the directory p_layer stands for, or the empty string if p_layer is unknown
+  QString get_layer_path(QString p_layer);
+
+public slots:
+  //Forgets every resolved path, call this after the theme or the character changed
+  void invalidate();
+  //Forgets what was resolved in layers under the paths the asset index reported
+  void on_index_changed(QStringList p_changed);
+
+private:
+  struct resolve_key
+  {
+    int layer_set;
+    int ext_set;
+    QString name;
+
+    bool operator==(const resolve_key &p_other) const
+    {
+      return layer_set == p_other.layer_set && ext_set == p_other.ext_set && name == p_other.name;
+    }
+  };
+
+  friend uint qHash(const resolve_key &p_key, uint p_seed = 0)
+  {
+    return qHash(p_key.name, p_seed) ^ uint(p_key.layer_set << 16) ^ uint(p_key.ext_set);
+  }
+
+  AOApplication *ao_app = nullptr;
+
+  //the resolver is also used by the decoding threads. Nobody holds it while the disk is asked
+  QReadWriteLock m_lock;
+
+  //bumped whenever results are dropped, so a lookup that raced it doesn't store a stale one
+  int m_generation = 0;
+
+  QVector<QStringList> m_layer_sets;
+  QHash<QStringList, int> m_layer_set_ids;
+  QVector<QVector<QString>> m_ext_sets;
+  QHash<QVector<QString>, int> m_ext_set_ids;
+
+  //"" is remembered for assets that don't exist
+  QHash<resolve_key, QString> m_resolved;
+  QHash<QString, QString> m_layer_paths;
+};
+
+#endif // AOASSETRESOLVER_HPP
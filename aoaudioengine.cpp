@@ -0,0 +1,419 @@
+#include "aoaudioengine.hpp"
+
+#include "aoapplication.h"
+#include "file_functions.h"
+
+#include <QRunnable>
+#include <QStringList>
+#include <QDebug>
+
+class AOMusicOpenTask : public QRunnable
+{
+public:
+  //p_generation is 0 for songs that were asked to play, prefetches carry theirs
+  AOMusicOpenTask(AOAudioEngine *p_engine, AOApplication *p_ao_app, QString p_song, int p_generation)
+    : m_engine(p_engine), ao_app(p_ao_app), m_song(p_song), m_generation(p_generation) {}
+
+  void run()
+  {
+    //a newer prefetch came along while this one was queued
+    if (m_generation != 0 && m_generation != m_engine->m_prefetch_generation.load())
+      return;
+
+    QString f_file = ao_app->get_music_path(AOAudioEngine::find_song(ao_app, m_song));
+
+    AOAudioEngine::command f_command;
+    f_command.type = AOAudioEngine::MUSIC_OPENED;
+    f_command.name = m_song;
+    f_command.value = m_generation;
+
+    if (is_packed_asset(f_file))
+    {
+      //bass reads straight from our buffer, so it has to live as long as the stream
+      f_command.data = read_asset(f_file);
+      f_command.stream = BASS_StreamCreateFile(TRUE, f_command.data.constData(), 0, f_command.data.size(), 0);
+    }
+    else
+      f_command.stream = BASS_StreamCreateFile(FALSE, f_file.utf16(), 0, 0, BASS_UNICODE|BASS_ASYNCFILE);
+
+    if (!f_command.stream)
+      qDebug() << f_file << "could not be initialized to play";
+    else
+      //fills the playback buffer here, so starting it later doesn't have to
+      BASS_ChannelUpdate(f_command.stream, 0);
+
+    m_engine->post(f_command);
+  }
+
+private:
+  AOAudioEngine *m_engine;
+  AOApplication *ao_app;
+  QString m_song;
+  int m_generation;
+};
+
+AOAudioEngine::AOAudioEngine(AOApplication *p_ao_app, QObject *p_parent)
+  : QThread(p_parent), ao_app(p_ao_app)
+{
+  m_clock.start();
+  m_open_pool.setMaxThreadCount(1);
+
+  start();
+}
+
+AOAudioEngine::~AOAudioEngine()
+{
+  command f_command;
+  f_command.type = QUIT;
+  post(f_command);
+
+  wait();
+}
+
+void AOAudioEngine::play_file(QString p_file, audio_bus p_bus, int p_owner, int p_volume)
+{
+  command f_command;
+  f_command.type = PLAY_FILE;
+  f_command.bus = p_bus;
+  f_command.owner = p_owner;
+  f_command.name = p_file;
+  f_command.value = p_volume;
+  post(f_command);
+}
+
+void AOAudioEngine::stop(int p_owner)
+{
+  command f_command;
+  f_command.type = STOP;
+  f_command.owner = p_owner;
+  post(f_command);
+}
+
+void AOAudioEngine::set_volume(int p_owner, int p_volume)
+{
+  command f_command;
+  f_command.type = SET_VOLUME;
+  f_command.owner = p_owner;
+  f_command.value = p_volume;
+  post(f_command);
+}
+
+void AOAudioEngine::stop_music()
+{
+  command f_command;
+  f_command.type = STOP_MUSIC;
+  post(f_command);
+}
+
+void AOAudioEngine::set_music_volume(int p_volume)
+{
+  command f_command;
+  f_command.type = SET_MUSIC_VOLUME;
+  f_command.value = p_volume;
+  post(f_command);
+}
+
+void AOAudioEngine::play_music(QString p_song)
+{
+  command f_command;
+  f_command.type = PLAY_MUSIC;
+  f_command.name = p_song;
+  post(f_command);
+}
+
+void AOAudioEngine::prefetch_music(QString p_song)
+{
+  command f_command;
+  f_command.type = PREFETCH_MUSIC;
+  f_command.name = p_song;
+  post(f_command);
+}
+
+void AOAudioEngine::on_index_changed(QStringList p_changed)
+{
+  command f_command;
+  f_command.type = INVALIDATE;
+  f_command.paths = p_changed;
+  post(f_command);
+}
+
+AOAudioEngine::audio_stats AOAudioEngine::get_stats()
+{
+  QMutexLocker f_locker(&m_stats_mutex);
+  return m_stats;
+}
+
+QString AOAudioEngine::find_song(AOApplication *p_ao_app, QString p_song)
+{
+  for (QString f_ext : QStringList{"", ".wav", ".ogg", ".mp3"})
+  {
+    if (file_exists(p_ao_app->get_music_path(p_song + f_ext)))
+      return p_song + f_ext;
+  }
+
+  return p_song;
+}
+
+void AOAudioEngine::post(command p_command)
+{
+  p_command.posted = m_clock.nsecsElapsed();
+
+  QMutexLocker f_locker(&m_queue_mutex);
+  m_queue.append(p_command);
+  m_queue_condition.wakeOne();
+}
+
+void AOAudioEngine::run()
+{
+  //the device belongs to the thread that set it up
+  BASS_Init(-1, 48000, BASS_DEVICE_LATENCY, 0, NULL);
+  BASS_PluginLoad("bassopus.dll", BASS_UNICODE);
+
+  m_mixer = new AOAudioMixer();
+
+  QVector<command> f_batch;
+  bool f_quit = false;
+
+  while (!f_quit)
+  {
+    {
+      QMutexLocker f_locker(&m_queue_mutex);
+      while (m_queue.isEmpty())
+        m_queue_condition.wait(&m_queue_mutex);
+      //the queue keeps its capacity for the next round
+      f_batch.swap(m_queue);
+    }
+
+    for (const command &f_command : f_batch)
+    {
+      if (f_command.type == QUIT)
+      {
+        f_quit = true;
+        break;
+      }
+
+      execute(f_command);
+    }
+
+    m_commands += f_batch.size();
+    f_batch.clear();
+
+    publish_stats();
+  }
+
+  //songs still being opened end up in the queue, they're freed along with the rest
+  m_open_pool.waitForDone();
+
+  {
+    QMutexLocker f_locker(&m_queue_mutex);
+    f_batch.swap(m_queue);
+  }
+
+  for (command &f_command : f_batch)
+  {
+    if (f_command.type == MUSIC_OPENED && f_command.stream)
+      BASS_StreamFree(f_command.stream);
+  }
+
+  free(m_current);
+  free(m_prefetched);
+
+  delete m_mixer;
+  m_mixer = nullptr;
+
+  BASS_Free();
+}
+
+void AOAudioEngine::execute(const command &p_command)
+{
+  switch (p_command.type)
+  {
+  case PLAY_FILE:
+    if (p_command.bus != MUSIC)
+      m_mixer->play_file(p_command.name, AOAudioMixer::voice_priority(p_command.bus), p_command.owner,
+                         p_command.value, m_clock.nsecsElapsed() - p_command.posted);
+    break;
+  case STOP:
+    m_mixer->stop(p_command.owner);
+    break;
+  case SET_VOLUME:
+    m_mixer->set_volume(p_command.owner, p_command.value);
+    break;
+  case STOP_MUSIC:
+    stop_song();
+    break;
+  case SET_MUSIC_VOLUME:
+    m_music_volume = p_command.value;
+    if (m_current.stream)
+      BASS_ChannelSetAttribute(m_current.stream, BASS_ATTRIB_VOL, m_music_volume / 100.0f);
+    break;
+  case PLAY_MUSIC:
+    play_song(p_command.name);
+    break;
+  case PREFETCH_MUSIC:
+    prefetch_song(p_command.name);
+    break;
+  case MUSIC_OPENED:
+  {
+    song f_song;
+    f_song.name = p_command.name;
+    f_song.stream = p_command.stream;
+    f_song.data = p_command.data;
+    on_song_opened(f_song, p_command.value);
+    break;
+  }
+  case INVALIDATE:
+    m_mixer->invalidate(p_command.paths);
+    break;
+  case QUIT:
+    break;
+  }
+}
+
+void AOAudioEngine::publish_stats()
+{
+  audio_stats f_stats;
+  f_stats.commands = m_commands;
+  f_stats.voices = m_mixer->get_voice_count();
+  f_stats.peak_voices = m_mixer->get_peak_voices();
+  f_stats.played = m_mixer->get_played();
+  f_stats.stolen = m_mixer->get_stolen();
+  f_stats.dropped = m_mixer->get_dropped();
+  f_stats.average_latency = m_mixer->get_average_latency();
+  f_stats.max_latency = m_mixer->get_max_latency();
+  f_stats.sample_hits = m_mixer->get_cache()->get_hits();
+  f_stats.sample_misses = m_mixer->get_cache()->get_misses();
+  f_stats.sample_bytes = m_mixer->get_cache()->get_bytes();
+  f_stats.sample_handles = m_mixer->get_cache()->get_handle_count();
+
+  QMutexLocker f_locker(&m_stats_mutex);
+  m_stats = f_stats;
+}
+
+void AOAudioEngine::play_song(QString p_song)
+{
+  //the server played the same song again
+  if (p_song == m_current.name && m_current.stream)
+  {
+    m_wanted = "";
+    BASS_ChannelPlay(m_current.stream, TRUE);
+    return;
+  }
+
+  if (p_song == m_prefetched.name && m_prefetched.stream)
+  {
+    song f_song = m_prefetched;
+    m_prefetched = song();
+    m_wanted = "";
+    start_song(f_song);
+    return;
+  }
+
+  m_wanted = p_song;
+
+  //a prefetch of it that hasn't started yet is dropped, one that has is picked up by whichever
+  //of the two is done first
+  if (p_song == m_prefetching)
+  {
+    m_prefetch_generation.ref();
+    m_prefetching = "";
+  }
+
+  //on_song_opened starts it once it's there. Ahead of any prefetch still waiting in the pool
+  m_open_pool.start(new AOMusicOpenTask(this, ao_app, p_song, 0), 1);
+}
+
+void AOAudioEngine::stop_song()
+{
+  m_wanted = "";
+
+  if (m_current.stream)
+    BASS_ChannelStop(m_current.stream);
+}
+
+void AOAudioEngine::prefetch_song(QString p_song)
+{
+  if (p_song == m_current.name || p_song == m_prefetched.name || p_song == m_prefetching || p_song == m_wanted)
+    return;
+
+  //only the last highlighted song is kept
+  free(m_prefetched);
+
+  m_prefetching = p_song;
+
+  //any older prefetch still waiting in the pool skips itself, so scrolling through the music
+  //list doesn't pile up opens in front of the next song that is actually played
+  int f_generation = m_prefetch_generation.fetchAndAddOrdered(1) + 1;
+  m_open_pool.start(new AOMusicOpenTask(this, ao_app, p_song, f_generation));
+}
+
+void AOAudioEngine::on_song_opened(song p_song, int p_generation)
+{
+  if (p_song.name == m_prefetching)
+    m_prefetching = "";
+
+  if (p_song.name == m_wanted)
+  {
+    m_wanted = "";
+
+    if (p_song.stream)
+      start_song(p_song);
+    else
+      stop_song();
+
+    return;
+  }
+
+  //a prefetch that was already running when a newer one came along is of no use either
+  bool is_stale = p_generation != 0 && p_generation != m_prefetch_generation.load();
+
+  if (p_song.stream && !is_stale && p_song.name != m_current.name && p_song.name != m_prefetched.name)
+  {
+    free(m_prefetched);
+    m_prefetched = p_song;
+    return;
+  }
+
+  //nobody wants it anymore
+  free(p_song);
+}
+
+void AOAudioEngine::start_song(song p_song)
+{
+  //the old song played until now
+  recycle(m_current);
+
+  m_current = p_song;
+
+  BASS_ChannelSetAttribute(m_current.stream, BASS_ATTRIB_VOL, m_music_volume / 100.0f);
+  //a fresh stream starts on the buffer the open task filled, restarting would throw it away
+  //and decode it again here. A recycled one has to go back to the beginning
+  BASS_ChannelPlay(m_current.stream, m_current.played ? TRUE : FALSE);
+  m_current.played = true;
+}
+
+void AOAudioEngine::recycle(song &p_song)
+{
+  if (!p_song.stream)
+    return;
+
+  BASS_ChannelStop(p_song.stream);
+
+  //a prefetched song or one on its way matters more than a replay
+  if (m_prefetched.stream || !m_prefetching.isEmpty())
+  {
+    free(p_song);
+    return;
+  }
+
+  m_prefetched = p_song;
+  p_song = song();
+}
+
+void AOAudioEngine::free(song &p_song)
+{
+  if (p_song.stream)
+    BASS_StreamFree(p_song.stream);
+
+  p_song = song();
+}
@@ -0,0 +1,182 @@
+#ifndef AOAUDIOENGINE_HPP
+#define AOAUDIOENGINE_HPP
+
+#include "aoaudiomixer.hpp"
+
+#include <QThread>
+#include <QThreadPool>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QByteArray>
+#include <QAtomicInt>
+
+#include <bass.h>
+
+class AOApplication;
+
+/**
+ * @brief The AOAudioEngine is the one thread that talks to BASS.
+ * It owns the device, every sample and stream, and the volume of each player. The players on
+ * the GUI thread only post small commands to its queue and never wait on it, the engine
+ * works through whatever piled up in one go. Songs are opened on a pool of its own, so a
+ * slow disk holds up the music and nothing else.
+ */
+
+class AOAudioEngine : public QThread
+{
+  Q_OBJECT
+
+public:
+  enum audio_bus
+  {
+    BLIP = AOAudioMixer::BLIP,
+    SFX = AOAudioMixer::SFX,
+    SHOUT = AOAudioMixer::SHOUT,
+    MUSIC
+  };
+
+  struct audio_stats
+  {
+    int commands = 0;
+    int voices = 0;
+    int peak_voices = 0;
+    int played = 0;
+    int stolen = 0;
+    int dropped = 0;
+    //microseconds from posting a sound to it playing
+    qint64 average_latency = 0;
+    qint64 max_latency = 0;
+    int sample_hits = 0;
+    int sample_misses = 0;
+    int sample_bytes = 0;
+    int sample_handles = 0;
+  };
+
+  AOAudioEngine(AOApplication *p_ao_app, QObject *p_parent = nullptr);
+  ~AOAudioEngine();
+
+  //Plays p_file out of the sample cache for the player p_owner at p_volume (0-100).
+  //p_bus is one of the voice buses, it decides what gets cut off when the mixer is full
+  void play_file(QString p_file, audio_bus p_bus, int p_owner, int p_volume);
+  //Stops everything p_owner has playing
+  void stop(int p_owner);
+  //0-100, applied to what p_owner has playing
+  void set_volume(int p_owner, int p_volume);
+
+  void stop_music();
+  //0-100, applied to the song that is playing as well
+  void set_music_volume(int p_volume);
+
+  //p_song is the name the server uses, with or without an extension.
+  //The old song plays on until the new one is open
+  void play_music(QString p_song);
+  //Opens p_song ahead of time so that play_music() doesn't have to wait for it
+  void prefetch_music(QString p_song);
+
+  //Returns what the engine counted as of the last batch it worked through
+  audio_stats get_stats();
+
+  //Returns p_song with the extension it has on the disk, tried in the order play_music() does
+  static QString find_song(AOApplication *p_ao_app, QString p_song);
+
+public slots:
+  //p_changed are the paths the asset index reported, the samples of files under them are dropped
+  void on_index_changed(QStringList p_changed);
+
+protected:
+  void run() override;
+
+private:
+  enum command_type
+  {
+    PLAY_FILE,
+    STOP,
+    SET_VOLUME,
+    STOP_MUSIC,
+    SET_MUSIC_VOLUME,
+    PLAY_MUSIC,
+    PREFETCH_MUSIC,
+    MUSIC_OPENED,
+    INVALIDATE,
+    QUIT
+  };
+
+  struct command
+  {
+    command_type type = QUIT;
+    audio_bus bus = SFX;
+    //the player a sound belongs to
+    int owner = 0;
+    //a file or a song name
+    QString name;
+    //changed paths, for INVALIDATE
+    QStringList paths;
+    int value = 0;
+    //an opened song and the buffer it plays out of
+    HSTREAM stream = 0;
+    QByteArray data;
+    //when it was posted, on m_clock
+    qint64 posted = 0;
+  };
+
+  struct song
+  {
+    QString name;
+    HSTREAM stream = 0;
+    //packed songs are played straight out of this
+    QByteArray data;
+    //false while the stream still holds what the open task prebuffered, true once it has played
+    bool played = false;
+  };
+
+  AOApplication *ao_app;
+
+  //everything past here that isn't guarded by a mutex is only touched on the audio thread
+  QMutex m_queue_mutex;
+  QWaitCondition m_queue_condition;
+  QVector<command> m_queue;
+
+  QElapsedTimer m_clock;
+
+  AOAudioMixer *m_mixer = nullptr;
+  int m_music_volume = 100;
+
+  song m_current;
+  //a song opened ahead of time, or the last one that played, so it can be restarted
+  song m_prefetched;
+  //what play_music() asked for last, "" once it's playing
+  QString m_wanted;
+  //what is being prefetched right now
+  QString m_prefetching;
+
+  //one song at a time, so a prefetch never races the song that was asked for
+  QThreadPool m_open_pool;
+  //bumped for every prefetch, queued prefetches from before it are skipped
+  QAtomicInt m_prefetch_generation;
+
+  QMutex m_stats_mutex;
+  audio_stats m_stats;
+  int m_commands = 0;
+
+  friend class AOMusicOpenTask;
+
+  void post(command p_command);
+  void execute(const command &p_command);
+  void publish_stats();
+
+  void play_song(QString p_song);
+  void stop_song();
+  void prefetch_song(QString p_song);
+  //p_generation is the prefetch generation it was opened for, 0 if it was asked to play
+  void on_song_opened(song p_song, int p_generation);
+  void start_song(song p_song);
+  //keeps p_song around for a replay if there's room, frees it otherwise
+  void recycle(song &p_song);
+  static void free(song &p_song);
+};
+
+#endif // AOAUDIOENGINE_HPP
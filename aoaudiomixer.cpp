@@ -0,0 +1,179 @@
+#include "aoaudiomixer.hpp"
+
+#include "file_functions.h"
+
+#include <QElapsedTimer>
+#include <QDebug>
+
+//samples are short, a few of the same one overlapping is plenty
+static const int sample_channels = 4;
+
+AOAudioMixer::AOAudioMixer()
+  : m_cache(cache_budget, sample_channels)
+{
+
+}
+
+AOAudioMixer::~AOAudioMixer()
+{
+  //sampled voices go with their samples, streamed ones have to be stopped
+  for (const voice &f_voice : m_voices)
+  {
+    if (f_voice.streamed)
+      BASS_ChannelStop(f_voice.channel);
+  }
+}
+
+void AOAudioMixer::play_file(QString p_file, voice_priority p_priority, int p_owner, int p_volume, qint64 p_queued)
+{
+  QElapsedTimer f_requested;
+  f_requested.start();
+
+  if (!reserve_voice(p_priority))
+    return;
+
+  voice f_voice;
+
+  //long ones aren't worth decoding up front
+  if (!m_cache.is_oversized(p_file))
+    f_voice.channel = BASS_SampleGetChannel(m_cache.get_sample(p_file), FALSE);
+
+  //it may only just have been found to be too big
+  if (!f_voice.channel && m_cache.is_oversized(p_file))
+    f_voice = open_stream(p_file);
+
+  if (!f_voice.channel)
+    return;
+
+  f_voice.priority = p_priority;
+  f_voice.owner = p_owner;
+  f_voice.volume = p_volume;
+
+  start_voice(f_voice, p_queued + f_requested.nsecsElapsed());
+}
+
+void AOAudioMixer::stop(int p_owner)
+{
+  for (const voice &f_voice : m_voices)
+  {
+    if (f_voice.owner == p_owner)
+      BASS_ChannelStop(f_voice.channel);
+  }
+
+  prune();
+}
+
+void AOAudioMixer::set_volume(int p_owner, int p_volume)
+{
+  for (voice &f_voice : m_voices)
+  {
+    if (f_voice.owner != p_owner)
+      continue;
+
+    f_voice.volume = p_volume;
+    BASS_ChannelSetAttribute(f_voice.channel, BASS_ATTRIB_VOL, p_volume / 100.0f);
+  }
+}
+
+void AOAudioMixer::invalidate(QStringList p_changed)
+{
+  //what is playing out of them finishes first
+  m_cache.remove(p_changed);
+}
+
+int AOAudioMixer::get_voice_count()
+{
+  prune();
+  return m_voices.size();
+}
+
+void AOAudioMixer::prune()
+{
+  for (int n_voice = m_voices.size() - 1 ; n_voice >= 0 ; --n_voice)
+  {
+    //channels that were freed or taken over by their sample count as stopped too
+    if (BASS_ChannelIsActive(m_voices.at(n_voice).channel) == BASS_ACTIVE_STOPPED)
+      m_voices.remove(n_voice);
+  }
+}
+
+bool AOAudioMixer::reserve_voice(voice_priority p_priority)
+{
+  prune();
+
+  if (m_voices.size() < max_voices)
+    return true;
+
+  //the least important voice, the oldest of those
+  int f_victim = -1;
+
+  for (int n_voice = 0 ; n_voice < m_voices.size() ; ++n_voice)
+  {
+    const voice &f_voice = m_voices.at(n_voice);
+
+    if (f_voice.priority > p_priority)
+      continue;
+
+    if (f_victim == -1 || f_voice.priority < m_voices.at(f_victim).priority ||
+        (f_voice.priority == m_voices.at(f_victim).priority && f_voice.serial < m_voices.at(f_victim).serial))
+      f_victim = n_voice;
+  }
+
+  if (f_victim == -1)
+  {
+    ++m_dropped;
+    return false;
+  }
+
+  BASS_ChannelStop(m_voices.at(f_victim).channel);
+  m_voices.remove(f_victim);
+  ++m_stolen;
+
+  return true;
+}
+
+void AOAudioMixer::start_voice(voice p_voice, qint64 p_requested)
+{
+  QElapsedTimer f_timer;
+  f_timer.start();
+
+  BASS_ChannelSetAttribute(p_voice.channel, BASS_ATTRIB_VOL, p_voice.volume / 100.0f);
+  BASS_ChannelPlay(p_voice.channel, TRUE);
+
+  //the sample may have handed out a channel it took back from one of our voices
+  for (int n_voice = m_voices.size() - 1 ; n_voice >= 0 ; --n_voice)
+  {
+    if (m_voices.at(n_voice).channel == p_voice.channel)
+      m_voices.remove(n_voice);
+  }
+
+  p_voice.serial = m_next_serial++;
+  m_voices.append(p_voice);
+
+  m_peak_voices = qMax(m_peak_voices, m_voices.size());
+
+  qint64 f_latency = p_requested + f_timer.nsecsElapsed();
+  ++m_played;
+  m_total_latency += f_latency;
+  m_max_latency = qMax(m_max_latency, f_latency);
+}
+
+AOAudioMixer::voice AOAudioMixer::open_stream(QString p_file)
+{
+  voice f_voice;
+  f_voice.streamed = true;
+
+  if (is_packed_asset(p_file))
+  {
+    //bass reads straight from our buffer, it's dropped along with the voice
+    f_voice.data = read_asset(p_file);
+    f_voice.channel = BASS_StreamCreateFile(TRUE, f_voice.data.constData(), 0, f_voice.data.size(), BASS_STREAM_AUTOFREE);
+  }
+  else
+    f_voice.channel = BASS_StreamCreateFile(FALSE, p_file.utf16(), 0, 0, BASS_UNICODE|BASS_ASYNCFILE|BASS_STREAM_AUTOFREE);
+
+  if (!f_voice.channel)
+    qDebug() << p_file << "could not be initialized to play";
+
+  return f_voice;
+}
@@ -0,0 +1,97 @@
+#ifndef AOAUDIOMIXER_HPP
+#define AOAUDIOMIXER_HPP
+
+#include "aosamplecache.hpp"
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QByteArray>
+
+#include <bass.h>
+
+/**
+ * @brief The AOAudioMixer starts every short sound: shouts, sfx and blips.
+ * It keeps track of what is playing and never lets more than max_voices sound at once.
+ * When it's full, a new sound takes the place of the oldest one of the same or a lower
+ * priority, or isn't played at all if everything playing matters more. Each voice remembers
+ * the player that started it, so volume and stopping stay per player.
+ * It belongs to the AOAudioEngine and is only ever used on the audio thread.
+ */
+
+class AOAudioMixer
+{
+public:
+  enum voice_priority
+  {
+    BLIP,
+    SFX,
+    SHOUT
+  };
+
+  AOAudioMixer();
+  ~AOAudioMixer();
+
+  //Plays p_file for the player p_owner at p_volume (0-100) out of the sample cache, files too big
+  //for it are streamed. p_queued is how long the request waited to get here, in nanoseconds
+  void play_file(QString p_file, voice_priority p_priority, int p_owner, int p_volume, qint64 p_queued = 0);
+
+  //Stops every voice p_owner started
+  void stop(int p_owner);
+
+  //0-100, applied to what p_owner has playing
+  void set_volume(int p_owner, int p_volume);
+
+  //files under p_changed changed on disk, their samples may be stale
+  void invalidate(QStringList p_changed);
+
+  int get_voice_count();
+  int get_peak_voices() {return m_peak_voices;}
+  int get_played() {return m_played;}
+  int get_stolen() {return m_stolen;}
+  int get_dropped() {return m_dropped;}
+  //how long it takes from a request to the channel playing, in microseconds
+  qint64 get_average_latency() {return m_played > 0 ? m_total_latency / m_played / 1000 : 0;}
+  qint64 get_max_latency() {return m_max_latency / 1000;}
+
+  AOSampleCache *get_cache() {return &m_cache;}
+
+  static const int max_voices = 16;
+  static const int cache_budget = 32 * 1024 * 1024;
+
+private:
+  struct voice
+  {
+    HCHANNEL channel = 0;
+    voice_priority priority = SFX;
+    int owner = 0;
+    int volume = 100;
+    //the order voices were started in
+    quint64 serial = 0;
+    //streamed voices free themselves when they end, packed ones play out of this
+    bool streamed = false;
+    QByteArray data;
+  };
+
+  AOSampleCache m_cache;
+
+  QVector<voice> m_voices;
+  quint64 m_next_serial = 0;
+
+  int m_peak_voices = 0;
+  int m_played = 0;
+  int m_stolen = 0;
+  int m_dropped = 0;
+  qint64 m_total_latency = 0;
+  qint64 m_max_latency = 0;
+
+  //forgets the voices that are done playing
+  void prune();
+  //makes room for a voice of p_priority. Returns false if nothing may be cut off
+  bool reserve_voice(voice_priority p_priority);
+  void start_voice(voice p_voice, qint64 p_requested);
+  //opens p_file as a stream that frees itself once it's done, for files too big to cache
+  voice open_stream(QString p_file);
+};
+
+#endif // AOAUDIOMIXER_HPP
@@ -1,26 +1,43 @@
 #include "aoblipplayer.h"
 
-#include <string.h>
-
-#include <QDebug>
-
 AOBlipPlayer::AOBlipPlayer(QObject *p_parent, AOApplication *p_ao_app)
     : AOAbstractPlayer(p_parent, p_ao_app)
-{}
+{
+    m_timer = new AOClockTimer(ao_app->frame_clock, this);
+
+    connect(this, &AOBlipPlayer::new_volume, [this](int p_volume) {
+        ao_app->audio_engine->set_volume(get_id(), p_volume);
+    });
+
+    connect(m_timer, SIGNAL(timeout()), this, SLOT(play()));
+}
 
 void AOBlipPlayer::set_file(QString p_file)
 {
     m_file = ao_app->get_sounds_path() + QString("sfx-blip%1.wav").arg(p_file).toLower();
 }
 
+void AOBlipPlayer::start(int p_interval)
+{
+    m_timer->start(qMax(1, p_interval));
+    play();
+}
+
+void AOBlipPlayer::stop()
+{
+    m_timer->stop();
+}
+
+void AOBlipPlayer::set_quiet(bool p_quiet)
+{
+    m_quiet = p_quiet;
+}
+
 void AOBlipPlayer::play()
 {
-    try {
-        AOBassHandle *handle = new AOBassHandle(m_file, true, this);
-        connect(this, &AOBlipPlayer::new_volume, handle, &AOBassHandle::set_volume);
-        handle->set_volume(get_volume());
-        handle->play();
-    } catch (const std::exception &e_exception) {
-        qDebug() << e_exception.what();
-    }
+    if (m_quiet || m_file.isEmpty())
+        return;
+
+    //blips are the first to go when the mixer is full
+    ao_app->audio_engine->play_file(m_file, AOAudioEngine::BLIP, get_id(), get_volume());
 }
@@ -2,6 +2,14 @@
 #define AOBLIPPLAYER_H
 
 #include "aoabstractplayer.hpp"
+#include "aoframeclock.hpp"
+
+/**
+ * @brief The AOBlipPlayer plays the blips while a message ticks in.
+ * Blip sounds are decoded once into the audio engine's sample cache, so a blip is only a
+ * command to trigger one of its channels. Blips keep their own time on the frame clock,
+ * the courtroom only tells it when to start and stop and whether to stay quiet.
+ */
 
 class AOBlipPlayer : public AOAbstractPlayer
 {
@@ -12,11 +20,21 @@ public:
 
     void set_file(QString p_file);
 
+    //Blips right away and then every p_interval ms until stop()
+    void start(int p_interval);
+    void stop();
+
+    //Quiet blips are skipped, the timing carries on
+    void set_quiet(bool p_quiet);
+
 public slots:
     void play();
 
 private:
     QString m_file;
+    bool m_quiet = false;
+
+    AOClockTimer *m_timer;
 };
 
 #endif // AOBLIPPLAYER_H
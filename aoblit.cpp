@@ -0,0 +1,262 @@
+#include "aoblit.hpp"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AO_BLIT_SSE2
+#endif
+
+//only when the whole client is built for it (-mavx2, /arch:AVX2), there's no runtime dispatch
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define AO_BLIT_AVX2
+#endif
+
+bool is_integer_scale(QSize p_source, QSize p_size)
+{
+  return p_source.width() > 0 && p_source.height() > 0 &&
+      p_size.width() >= p_source.width() && p_size.height() >= p_source.height() &&
+      p_size.width() % p_source.width() == 0 && p_size.height() % p_source.height() == 0;
+}
+
+//Writes every pixel of p_src p_factor times into p_dst, back to front if p_flipped
+static void blit_row(const quint32 *p_src, int p_width, quint32 *p_dst, int p_factor, bool p_flipped)
+{
+  if (p_factor == 1 && !p_flipped)
+  {
+    memcpy(p_dst, p_src, p_width * 4);
+    return;
+  }
+
+  int n_pixel = 0;
+
+#ifdef AO_BLIT_AVX2
+  if (p_factor == 1 || p_factor == 2)
+  {
+    const __m256i f_reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    const __m256i f_low = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+    const __m256i f_high = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+    //eight source pixels at a time
+    for ( ; n_pixel + 8 <= p_width ; n_pixel += 8)
+    {
+      __m256i f_pixels;
+
+      if (p_flipped)
+      {
+        f_pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_src + p_width - n_pixel - 8));
+        f_pixels = _mm256_permutevar8x32_epi32(f_pixels, f_reverse);
+      }
+      else
+        f_pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_src + n_pixel));
+
+      __m256i *f_out = reinterpret_cast<__m256i*>(p_dst + n_pixel * p_factor);
+
+      if (p_factor == 1)
+        _mm256_storeu_si256(f_out, f_pixels);
+      else
+      {
+        _mm256_storeu_si256(f_out, _mm256_permutevar8x32_epi32(f_pixels, f_low));
+        _mm256_storeu_si256(f_out + 1, _mm256_permutevar8x32_epi32(f_pixels, f_high));
+      }
+    }
+  }
+  else if (p_factor >= 8)
+  {
+    for ( ; n_pixel < p_width ; ++n_pixel)
+    {
+      quint32 f_pixel = p_flipped ? p_src[p_width - n_pixel - 1] : p_src[n_pixel];
+      __m256i f_wide = _mm256_set1_epi32(static_cast<int>(f_pixel));
+      quint32 *f_out = p_dst + n_pixel * p_factor;
+
+      int n_copy = 0;
+      for ( ; n_copy + 8 <= p_factor ; n_copy += 8)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(f_out + n_copy), f_wide);
+      for ( ; n_copy < p_factor ; ++n_copy)
+        f_out[n_copy] = f_pixel;
+    }
+  }
+#endif
+
+#ifdef AO_BLIT_SSE2
+  //picks up where the avx2 loops stopped, if they ran
+  if (p_factor == 1 || p_factor == 2)
+  {
+    //four source pixels at a time
+    for ( ; n_pixel + 4 <= p_width ; n_pixel += 4)
+    {
+      __m128i f_pixels;
+
+      if (p_flipped)
+      {
+        f_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + p_width - n_pixel - 4));
+        f_pixels = _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(0, 1, 2, 3));
+      }
+      else
+        f_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + n_pixel));
+
+      __m128i *f_out = reinterpret_cast<__m128i*>(p_dst + n_pixel * p_factor);
+
+      if (p_factor == 1)
+        _mm_storeu_si128(f_out, f_pixels);
+      else
+      {
+        _mm_storeu_si128(f_out, _mm_unpacklo_epi32(f_pixels, f_pixels));
+        _mm_storeu_si128(f_out + 1, _mm_unpackhi_epi32(f_pixels, f_pixels));
+      }
+    }
+  }
+  else if (p_factor == 3)
+  {
+    //four source pixels make three vectors: 0001 1122 2333
+    for ( ; n_pixel + 4 <= p_width ; n_pixel += 4)
+    {
+      __m128i f_pixels;
+
+      if (p_flipped)
+      {
+        f_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + p_width - n_pixel - 4));
+        f_pixels = _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(0, 1, 2, 3));
+      }
+      else
+        f_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + n_pixel));
+
+      __m128i *f_out = reinterpret_cast<__m128i*>(p_dst + n_pixel * 3);
+
+      _mm_storeu_si128(f_out, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(1, 0, 0, 0)));
+      _mm_storeu_si128(f_out + 1, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(2, 2, 1, 1)));
+      _mm_storeu_si128(f_out + 2, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(3, 3, 3, 2)));
+    }
+  }
+  else if (p_factor == 4)
+  {
+    //four source pixels, one vector each
+    for ( ; n_pixel + 4 <= p_width ; n_pixel += 4)
+    {
+      __m128i f_pixels;
+
+      if (p_flipped)
+      {
+        f_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + p_width - n_pixel - 4));
+        f_pixels = _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(0, 1, 2, 3));
+      }
+      else
+        f_pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_src + n_pixel));
+
+      __m128i *f_out = reinterpret_cast<__m128i*>(p_dst + n_pixel * 4);
+
+      _mm_storeu_si128(f_out, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(0, 0, 0, 0)));
+      _mm_storeu_si128(f_out + 1, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(1, 1, 1, 1)));
+      _mm_storeu_si128(f_out + 2, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(2, 2, 2, 2)));
+      _mm_storeu_si128(f_out + 3, _mm_shuffle_epi32(f_pixels, _MM_SHUFFLE(3, 3, 3, 3)));
+    }
+  }
+  else if (p_factor > 4)
+  {
+    //one source pixel fills whole vectors
+    for ( ; n_pixel < p_width ; ++n_pixel)
+    {
+      quint32 f_pixel = p_flipped ? p_src[p_width - n_pixel - 1] : p_src[n_pixel];
+      __m128i f_wide = _mm_set1_epi32(static_cast<int>(f_pixel));
+      quint32 *f_out = p_dst + n_pixel * p_factor;
+
+      int n_copy = 0;
+      for ( ; n_copy + 4 <= p_factor ; n_copy += 4)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(f_out + n_copy), f_wide);
+      for ( ; n_copy < p_factor ; ++n_copy)
+        f_out[n_copy] = f_pixel;
+    }
+  }
+#endif
+
+  //whatever the vectors didn't get to
+  for ( ; n_pixel < p_width ; ++n_pixel)
+  {
+    quint32 f_pixel = p_flipped ? p_src[p_width - n_pixel - 1] : p_src[n_pixel];
+    quint32 *f_out = p_dst + n_pixel * p_factor;
+
+    for (int n_copy = 0 ; n_copy < p_factor ; ++n_copy)
+      f_out[n_copy] = f_pixel;
+  }
+}
+
+QImage scale_frame(QImage p_image, QSize p_size, bool p_flipped)
+{
+  if (p_image.isNull())
+    return p_image;
+
+  //converting is cheaper before scaling, there are fewer pixels
+  p_image = p_image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+  QSize f_source = p_image.size();
+  QSize f_size = p_size.isValid() ? p_size : f_source;
+
+  if (!is_integer_scale(f_source, f_size))
+  {
+    p_image = p_image.scaled(f_size);
+
+    if (p_flipped)
+      p_image = p_image.mirrored(true, false);
+
+    return p_image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+  }
+
+  if (f_size == f_source && !p_flipped)
+    return p_image;
+
+  int f_x_factor = f_size.width() / f_source.width();
+  int f_y_factor = f_size.height() / f_source.height();
+
+  QImage f_scaled(f_size, QImage::Format_ARGB32_Premultiplied);
+
+  for (int n_row = 0 ; n_row < f_source.height() ; ++n_row)
+  {
+    const quint32 *f_src = reinterpret_cast<const quint32*>(p_image.constScanLine(n_row));
+    uchar *f_first = f_scaled.scanLine(n_row * f_y_factor);
+
+    blit_row(f_src, f_source.width(), reinterpret_cast<quint32*>(f_first), f_x_factor, p_flipped);
+
+    //the other rows of this source row are the same
+    for (int n_copy = 1 ; n_copy < f_y_factor ; ++n_copy)
+      memcpy(f_scaled.scanLine(n_row * f_y_factor + n_copy), f_first, f_size.width() * 4);
+  }
+
+  return f_scaled;
+}
+
+QRect opaque_rect(const QImage &p_image)
+{
+  int f_left = p_image.width();
+  int f_right = -1;
+  int f_top = -1;
+  int f_bottom = -1;
+
+  for (int n_row = 0 ; n_row < p_image.height() ; ++n_row)
+  {
+    const quint32 *f_line = reinterpret_cast<const quint32*>(p_image.constScanLine(n_row));
+
+    int f_first = 0;
+    while (f_first < p_image.width() && (f_line[f_first] >> 24) == 0)
+      ++f_first;
+
+    if (f_first == p_image.width())
+      continue;
+
+    //only what lies outside the columns we already have left to look at
+    int f_last = p_image.width() - 1;
+    while (f_last > f_right && (f_line[f_last] >> 24) == 0)
+      --f_last;
+
+    if (f_top < 0)
+      f_top = n_row;
+    f_bottom = n_row;
+    f_left = qMin(f_left, f_first);
+    f_right = qMax(f_right, f_last);
+  }
+
+  if (f_top < 0)
+    return QRect();
+
+  return QRect(QPoint(f_left, f_top), QPoint(f_right, f_bottom));
+}
@@ -0,0 +1,24 @@
+#ifndef AOBLIT_HPP
+#define AOBLIT_HPP
+
+#include <QImage>
+#include <QSize>
+#include <QRect>
+
+//Nearest-neighbour scaling for pixel art. When p_size is a whole multiple of the image size the rows
+//are blown up by a dedicated kernel (SSE2 where available, AVX2 if the client is built for it), with the
+//mirroring done in the same pass.
+//Anything else goes through QImage::scaled and QImage::mirrored like before.
+
+//Returns p_image scaled to p_size (left alone if p_size is invalid) and mirrored if p_flipped,
+//as premultiplied ARGB32
+QImage scale_frame(QImage p_image, QSize p_size, bool p_flipped);
+
+//Returns the smallest rectangle holding every pixel of p_image that isn't fully transparent,
+//an empty one if there is none. p_image has to be premultiplied ARGB32, like scale_frame returns
+QRect opaque_rect(const QImage &p_image);
+
+//Returns true if p_size is a whole multiple of p_source in both directions
+bool is_integer_scale(QSize p_source, QSize p_size);
+
+#endif // AOBLIT_HPP
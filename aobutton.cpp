@@ -17,14 +17,14 @@ AOButton::~AOButton()
 
 void AOButton::set_image(QString p_image)
 {
-  QString f_image_name = p_image.left(p_image.lastIndexOf(QChar('.')));
-  QString image_path = ao_app->get_theme_path() + p_image;
-  QString hover_image_path = ao_app->get_theme_path() + f_image_name + "_hover.png";
-  QString default_image_path = ao_app->get_default_theme_path() + p_image;
+  QString image_path = ao_app->asset_resolver->resolve({"theme"}, p_image);
 
-  if (file_exists(image_path))
+  if (image_path != "")
     {
-      if(file_exists(hover_image_path))
+      QString f_image_name = p_image.left(p_image.lastIndexOf(QChar('.')));
+      QString hover_image_path = ao_app->asset_resolver->resolve({"theme"}, f_image_name + "_hover.png");
+
+      if(hover_image_path != "")
         this->setStyleSheet("QPushButton {border-image:url(\"" + image_path + "\");}"
                             "QPushButton:hover {border-image:url(\"" + hover_image_path + "\");}");
       else
@@ -32,5 +32,5 @@ void AOButton::set_image(QString p_image)
     }
 
   else
-    this->setStyleSheet("border-image:url(\"" + default_image_path + "\")");
+    this->setStyleSheet("border-image:url(\"" + ao_app->get_default_theme_path() + p_image + "\")");
 }
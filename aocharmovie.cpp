@@ -1,84 +1,125 @@
 #include "aocharmovie.h"
 
-#include "misc_functions.h"
 #include "file_functions.h"
 #include "aoapplication.h"
+#include "aoviewport.hpp"
 
 #include <QDebug>
-#include <QImageReader>
 
 AOCharMovie::AOCharMovie(QWidget *p_parent, AOApplication *p_ao_app) : QLabel(p_parent)
 {
   ao_app = p_ao_app;
 
-  m_movie = new QMovie(this);
+  m_player = new AOFramePlayer(this, ao_app);
 
-  preanim_timer = new QTimer(this);
+  preanim_timer = new AOClockTimer(ao_app->frame_clock, this);
   preanim_timer->setSingleShot(true);
 
-  connect(m_movie, SIGNAL(frameChanged(int)), this, SLOT(frame_change(int)));
+  connect(m_player, SIGNAL(finished()), this, SLOT(timer_done()));
   connect(preanim_timer, SIGNAL(timeout()), this, SLOT(timer_done()));
+  connect(ao_app->frame_cache, SIGNAL(frames_decoded(QString)), this, SLOT(on_frames_decoded(QString)));
 }
 
-void AOCharMovie::play(QString p_char, QString p_emote, QString emote_prefix)
+QString AOCharMovie::get_image_path(QString p_char, QString p_emote, QString emote_prefix)
 {
-  QString original_path = ao_app->get_character_path(p_char) + emote_prefix + p_emote.toLower() + ".gif";
-  QString alt_path = ao_app->get_character_path(p_char) + p_emote.toLower() + ".png";
-  QString placeholder_path = ao_app->get_theme_path() + "placeholder.gif";
-  QString placeholder_default_path = ao_app->get_default_theme_path() + "placeholder.gif";
-  QString gif_path;
-
-  if (file_exists(original_path))
-    gif_path = original_path;
-  else if (file_exists(alt_path))
-    gif_path = alt_path;
-  else if (file_exists(placeholder_path))
-    gif_path = placeholder_path;
-  else
-    gif_path = placeholder_default_path;
+  AOAssetResolver *resolver = ao_app->asset_resolver;
+  int char_layer = resolver->get_layer_set({"character:" + p_char});
+  QString f_emote = p_emote.toLower();
 
-  m_movie->stop();
-  m_movie->setFileName(gif_path);
+  QString gif_path = resolver->resolve(char_layer, emote_prefix + f_emote + ".gif");
 
-  QImageReader *reader = new QImageReader(gif_path);
+  if (gif_path == "")
+    gif_path = resolver->resolve(char_layer, f_emote + ".png");
+  if (gif_path == "")
+    gif_path = resolver->resolve({"theme"}, "placeholder.gif");
+  if (gif_path == "")
+    gif_path = ao_app->get_default_theme_path() + "placeholder.gif";
 
-  movie_frames.clear();
-  QImage f_image = reader->read();
-  while (!f_image.isNull())
-  {
-    if (m_flipped)
-      movie_frames.append(f_image.mirrored(true, false));
-    else
-      movie_frames.append(f_image);
-    f_image = reader->read();
-  }
+  return gif_path;
+}
+
+void AOCharMovie::play(QString p_char, QString p_emote, QString emote_prefix)
+{
+  cancel_pending_pre();
 
-  delete reader;
+  m_player->set_speed(m_speed);
+  m_player->set_play_once(play_once);
 
   this->show();
 
-  m_movie->start();
+  m_player->play(get_image_path(p_char, p_emote, emote_prefix), this->size(), m_flipped);
 }
 
 void AOCharMovie::play_pre(QString p_char, QString p_emote, int duration)
 {
-  QString gif_path = ao_app->get_character_path(p_char) + p_emote.toLower();
-
-  m_movie->stop();
-  this->clear();
-  m_movie->setFileName(gif_path);
-  m_movie->jumpToFrame(0);
+  m_player->stop();
+  AOViewport::clear_pixmap(this);
+  cancel_pending_pre();
 
-  int full_duration = duration * time_mod;
-  int real_duration = 0;
+  QString f_path = get_image_path(p_char, p_emote, "");
 
   play_once = false;
 
-  for (int n_frame = 0 ; n_frame < m_movie->frameCount() ; ++n_frame)
+  //the delays come straight out of the file headers, the pixels get decoded by play() later
+  animation_info f_info = ao_app->animation_scanner->get_info(f_path);
+
+  if (f_info.valid)
+  {
+    start_pre(p_char, p_emote, duration, f_info.duration);
+    return;
+  }
+
+  //some format the scanner doesn't know, the decoder has to tell us
+  frame_set_ptr f_frames = ao_app->frame_cache->get_frames(f_path, m_flipped, this->size());
+
+  if (f_frames->is_finished())
   {
-    real_duration += m_movie->nextFrameDelay();
-    m_movie->jumpToFrame(n_frame + 1);
+    start_pre(p_char, p_emote, duration, get_duration(f_frames));
+    return;
   }
+
+  //picked up in on_frames_decoded. Held on to, so nobody else can cancel the decode meanwhile
+  ao_app->frame_cache->acquire(f_frames);
+  m_pending_frames = f_frames;
+  m_pending_char = p_char;
+  m_pending_emote = p_emote;
+  m_pending_duration = duration;
+}
+
+void AOCharMovie::on_frames_decoded(QString p_key)
+{
+  if (!m_pending_frames || p_key != m_pending_frames->key || !m_pending_frames->is_finished())
+    return;
+
+  int real_duration = get_duration(m_pending_frames);
+  cancel_pending_pre();
+
+  start_pre(m_pending_char, m_pending_emote, m_pending_duration, real_duration);
+}
+
+void AOCharMovie::cancel_pending_pre()
+{
+  if (!m_pending_frames)
+    return;
+
+  ao_app->frame_cache->release(m_pending_frames);
+  m_pending_frames.reset();
+}
+
+int AOCharMovie::get_duration(const frame_set_ptr &p_frames)
+{
+  int f_duration = 0;
+
+  for (int n_frame = 0 ; n_frame < p_frames->frame_count() ; ++n_frame)
+    f_duration += p_frames->get_delay(n_frame);
+
+  return f_duration;
+}
+
+void AOCharMovie::start_pre(QString p_char, QString p_emote, int duration, int real_duration)
+{
+  int full_duration = duration * time_mod;
+
   qDebug() << "full_duration: " << full_duration;
   qDebug() << "real_duration: " << real_duration;
 
@@ -104,41 +145,35 @@ void AOCharMovie::play_pre(QString p_char, QString p_emote, int duration)
     preanim_timer->start(full_duration);
   }
 
-
-  m_movie->setSpeed(static_cast<int>(percentage_modifier));
+  m_speed = static_cast<int>(percentage_modifier);
   play(p_char, p_emote, "");
 }
 
 void AOCharMovie::play_talking(QString p_char, QString p_emote)
 {
-  QString gif_path = ao_app->get_character_path(p_char) + "(b)" + p_emote.toLower();
-
-  m_movie->stop();
-  this->clear();
-  m_movie->setFileName(gif_path);
+  m_player->stop();
+  AOViewport::clear_pixmap(this);
 
   play_once = false;
-  m_movie->setSpeed(100);
+  m_speed = 100;
   play(p_char, p_emote, "(b)");
 }
 
 void AOCharMovie::play_idle(QString p_char, QString p_emote)
 {
-  QString gif_path = ao_app->get_character_path(p_char) + "(a)" + p_emote.toLower();
-
-  m_movie->stop();
-  this->clear();
-  m_movie->setFileName(gif_path);
+  m_player->stop();
+  AOViewport::clear_pixmap(this);
 
   play_once = false;
-  m_movie->setSpeed(100);
+  m_speed = 100;
   play(p_char, p_emote, "(a)");
 }
 
 void AOCharMovie::stop()
 {
   //for all intents and purposes, stopping is the same as hiding. at no point do we want a frozen gif to display
-  m_movie->stop();
+  cancel_pending_pre();
+  m_player->stop();
   preanim_timer->stop();
   this->hide();
 }
@@ -147,23 +182,7 @@ void AOCharMovie::combo_resize(int w, int h)
 {
   QSize f_size(w, h);
   this->resize(f_size);
-  m_movie->setScaledSize(f_size);
-}
-
-void AOCharMovie::frame_change(int n_frame)
-{
-  if (movie_frames.size() > n_frame)
-  {
-    QPixmap f_pixmap = QPixmap::fromImage(movie_frames.at(n_frame));
-
-    this->setPixmap(f_pixmap.scaled(this->width(), this->height()));
-  }
-
-  if (m_movie->frameCount() - 1 == n_frame && play_once)
-  {
-    preanim_timer->start(m_movie->nextFrameDelay());
-    m_movie->stop();
-  }
+  m_player->set_size(f_size);
 }
 
 void AOCharMovie::timer_done()
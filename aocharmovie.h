@@ -1,9 +1,9 @@
 #ifndef AOCHARMOVIE_H
 #define AOCHARMOVIE_H
 
-#include <QMovie>
 #include <QLabel>
-#include <QTimer>
+
+#include "aoframeplayer.hpp"
 
 class AOApplication;
 
@@ -28,22 +28,37 @@ public:
 private:
   AOApplication *ao_app = nullptr;
 
-  QMovie *m_movie;
-  QVector<QImage> movie_frames;
-  QTimer *preanim_timer;
+  AOFramePlayer *m_player;
+  AOClockTimer *preanim_timer;
 
   const int time_mod = 62;
 
+  //playback speed in percent, preanimations get slowed down to fit their duration
+  int m_speed = 100;
+
   bool m_flipped = false;
 
   bool play_once = true;
 
+  //a preanimation waiting for its frames to be decoded, only to learn how long it runs
+  frame_set_ptr m_pending_frames;
+  QString m_pending_char;
+  QString m_pending_emote;
+  int m_pending_duration = 0;
+
+  QString get_image_path(QString p_char, QString p_emote, QString emote_prefix);
+
+  //works out the speed and the timer of a preanimation that runs real_duration ms, then plays it
+  void start_pre(QString p_char, QString p_emote, int duration, int real_duration);
+  void cancel_pending_pre();
+  static int get_duration(const frame_set_ptr &p_frames);
+
 signals:
   void done();
 
 private slots:
-  void frame_change(int n_frame);
   void timer_done();
+  void on_frames_decoded(QString p_key);
 };
 
 #endif // AOCHARMOVIE_H
@@ -0,0 +1,426 @@
+#include "aochatarchive.hpp"
+
+#include "aolz4.hpp"
+
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QLocale>
+#include <QDataStream>
+#include <QTextStream>
+#include <QSaveFile>
+#include <QSet>
+#include <QtEndian>
+#include <QDebug>
+
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+
+AOChatArchive::AOChatArchive()
+{
+
+}
+
+QString AOChatArchive::get_archive_path(QString p_source)
+{
+  QFileInfo f_info(p_source);
+  return f_info.absolutePath() + "/archive/" + f_info.completeBaseName() + ".aoca";
+}
+
+QStringList AOChatArchive::tokenize(QString p_text)
+{
+  QStringList f_tokens;
+  QString f_token;
+
+  for (QChar f_char : p_text)
+  {
+    if (f_char.isLetterOrNumber())
+      f_token.append(f_char.toLower());
+    else if (!f_token.isEmpty())
+    {
+      f_tokens.append(f_token);
+      f_token.clear();
+    }
+  }
+
+  if (!f_token.isEmpty())
+    f_tokens.append(f_token);
+
+  return f_tokens;
+}
+
+bool AOChatArchive::open(QString p_file)
+{
+  close();
+
+  m_file.setFileName(p_file);
+  if (!m_file.open(QIODevice::ReadOnly))
+    return false;
+
+  QByteArray f_header = m_file.read(header_size);
+  const uchar *f_data = reinterpret_cast<const uchar*>(f_header.constData());
+
+  if (f_header.size() != header_size || memcmp(f_data, "AOCA", 4) != 0 ||
+      qFromLittleEndian<quint32>(f_data + 4) != archive_version)
+  {
+    qDebug() << "W:" << p_file << "is not a usable chat archive";
+    close();
+    return false;
+  }
+
+  quint32 f_message_count = qFromLittleEndian<quint32>(f_data + 8);
+  quint32 f_block_count = qFromLittleEndian<quint32>(f_data + 12);
+  quint64 f_index_offset = qFromLittleEndian<quint64>(f_data + 16);
+  quint64 f_index_size = qFromLittleEndian<quint64>(f_data + 24);
+  m_source_size = qFromLittleEndian<quint64>(f_data + 32);
+  m_source_time = qFromLittleEndian<qint64>(f_data + 40);
+
+  QVector<quint64> f_offsets;
+  QVector<quint32> f_stored_sizes;
+  QVector<quint32> f_raw_sizes;
+
+  if (f_index_offset + f_index_size <= quint64(m_file.size()) && m_file.seek(f_index_offset))
+  {
+    QByteArray f_index = qUncompress(m_file.read(f_index_size));
+
+    QDataStream f_in(f_index);
+    f_in.setVersion(QDataStream::Qt_5_7);
+    f_in >> m_speakers >> m_speaker_ids >> m_times >> f_offsets >> f_stored_sizes >> f_raw_sizes >> m_postings;
+
+    bool f_valid = f_in.status() == QDataStream::Ok &&
+        quint32(m_times.size()) == f_message_count && m_speaker_ids.size() == m_times.size() &&
+        quint32(f_offsets.size()) == f_block_count &&
+        f_stored_sizes.size() == f_offsets.size() && f_raw_sizes.size() == f_offsets.size() &&
+        quint64(f_offsets.size()) * block_messages >= f_message_count;
+
+    for (int n_block = 0 ; f_valid && n_block < f_offsets.size() ; ++n_block)
+      f_valid = f_offsets.at(n_block) + f_stored_sizes.at(n_block) <= f_index_offset;
+
+    for (int n_message = 0 ; f_valid && n_message < m_speaker_ids.size() ; ++n_message)
+      f_valid = m_speaker_ids.at(n_message) < quint32(m_speakers.size());
+
+    //search looks the speaker and time of every hit up by its id
+    for (QHash<QString, QVector<quint32>>::const_iterator it = m_postings.constBegin() ; f_valid && it != m_postings.constEnd() ; ++it)
+    {
+      for (quint32 f_id : it.value())
+      {
+        if (f_id >= quint32(m_times.size()))
+        {
+          f_valid = false;
+          break;
+        }
+      }
+    }
+
+    if (f_valid)
+    {
+      for (int n_block = 0 ; n_block < f_offsets.size() ; ++n_block)
+      {
+        block f_block;
+        f_block.offset = f_offsets.at(n_block);
+        f_block.stored_size = f_stored_sizes.at(n_block);
+        f_block.raw_size = f_raw_sizes.at(n_block);
+        m_blocks.append(f_block);
+      }
+
+      return true;
+    }
+  }
+
+  qDebug() << "W:" << p_file << "has a broken index";
+  close();
+  return false;
+}
+
+void AOChatArchive::close()
+{
+  m_file.close();
+
+  m_source_size = 0;
+  m_source_time = 0;
+  m_speakers.clear();
+  m_speaker_ids.clear();
+  m_times.clear();
+  m_blocks.clear();
+  m_postings.clear();
+  m_cached_block = -1;
+  m_cached_texts.clear();
+}
+
+bool AOChatArchive::is_current(QString p_source)
+{
+  QFileInfo f_info(p_source);
+
+  return quint64(f_info.size()) == m_source_size &&
+      f_info.lastModified().toMSecsSinceEpoch() == m_source_time;
+}
+
+QVector<quint32> AOChatArchive::search(QStringList p_tokens, QString p_speaker)
+{
+  QVector<quint32> f_result;
+  bool f_have_result = false;
+
+  //rarest token first, the intersection only ever gets smaller
+  QVector<const QVector<quint32>*> f_lists;
+  for (QString f_token : p_tokens)
+  {
+    QHash<QString, QVector<quint32>>::const_iterator f_postings = m_postings.constFind(f_token);
+    if (f_postings == m_postings.constEnd())
+      return QVector<quint32>();
+
+    f_lists.append(&f_postings.value());
+  }
+
+  std::sort(f_lists.begin(), f_lists.end(), [](const QVector<quint32> *a, const QVector<quint32> *b)
+  {
+    return a->size() < b->size();
+  });
+
+  for (const QVector<quint32> *f_list : f_lists)
+  {
+    if (!f_have_result)
+    {
+      f_result = *f_list;
+      f_have_result = true;
+      continue;
+    }
+
+    QVector<quint32> f_both;
+    std::set_intersection(f_result.constBegin(), f_result.constEnd(), f_list->constBegin(), f_list->constEnd(),
+                          std::back_inserter(f_both));
+    f_result = f_both;
+
+    if (f_result.isEmpty())
+      return f_result;
+  }
+
+  if (p_speaker.isEmpty())
+    return f_result;
+
+  QSet<quint32> f_speakers;
+  for (int n_speaker = 0 ; n_speaker < m_speakers.size() ; ++n_speaker)
+  {
+    if (m_speakers.at(n_speaker).compare(p_speaker, Qt::CaseInsensitive) == 0)
+      f_speakers.insert(quint32(n_speaker));
+  }
+
+  if (f_speakers.isEmpty())
+    return QVector<quint32>();
+
+  QVector<quint32> f_said;
+
+  if (!f_have_result)
+  {
+    //no words, everything the speaker said
+    for (int n_message = 0 ; n_message < m_speaker_ids.size() ; ++n_message)
+    {
+      if (f_speakers.contains(m_speaker_ids.at(n_message)))
+        f_said.append(quint32(n_message));
+    }
+  }
+  else
+  {
+    for (quint32 f_id : f_result)
+    {
+      if (f_speakers.contains(m_speaker_ids.at(f_id)))
+        f_said.append(f_id);
+    }
+  }
+
+  return f_said;
+}
+
+AOChatArchive::message AOChatArchive::read_message(quint32 p_id)
+{
+  message f_message;
+
+  if (p_id >= quint32(m_times.size()))
+    return f_message;
+
+  f_message.time = m_times.at(p_id);
+  f_message.speaker = m_speakers.at(m_speaker_ids.at(p_id));
+
+  int f_block = p_id / block_messages;
+
+  if (f_block != m_cached_block)
+  {
+    m_cached_block = -1;
+    m_cached_texts.clear();
+
+    const block &f_info = m_blocks.at(f_block);
+    QByteArray f_raw(f_info.raw_size, Qt::Uninitialized);
+
+    if (!m_file.seek(f_info.offset))
+      return f_message;
+
+    QByteArray f_stored = m_file.read(f_info.stored_size);
+
+    if (f_stored.size() != int(f_info.stored_size) ||
+        !lz4_decompress(f_stored.constData(), f_stored.size(), f_raw.data(), f_raw.size()))
+    {
+      qDebug() << "W:" << m_file.fileName() << "has a broken block" << f_block;
+      return f_message;
+    }
+
+    m_cached_texts = QString::fromUtf8(f_raw).split(QChar('\0'));
+    m_cached_block = f_block;
+  }
+
+  f_message.text = m_cached_texts.value(p_id % block_messages);
+  return f_message;
+}
+
+bool AOChatArchive::import_text_log(QString p_source, QString p_archive)
+{
+  QFile f_log(p_source);
+  if (!f_log.open(QIODevice::ReadOnly | QIODevice::Text))
+    return false;
+
+  QFileInfo f_info(p_source);
+  QString f_name = f_info.completeBaseName();
+
+  //the transcript's name is when it was started, lines only have the time of day
+  QDateTime f_start = QLocale::system().toDateTime(f_name, "ddd MMMM yyyy hh.mm.ss.z");
+  if (!f_start.isValid())
+    f_start = QLocale::c().toDateTime(f_name, "ddd MMMM yyyy hh.mm.ss.z");
+  if (!f_start.isValid())
+    f_start = f_info.lastModified();
+
+  QDate f_date = f_start.date();
+  QTime f_previous = f_start.time();
+
+  QVector<message> f_messages;
+
+  QTextStream f_in(&f_log);
+
+  while (!f_in.atEnd())
+  {
+    QString f_line = f_in.readLine();
+
+    //"[hh:mm:ss] showname: message"
+    QTime f_time = f_line.size() > 11 && f_line.at(0) == '[' && f_line.at(9) == ']' && f_line.at(10) == ' ' ?
+          QTime::fromString(f_line.mid(1, 8), "hh:mm:ss") : QTime();
+    int f_separator = f_time.isValid() ? f_line.indexOf(": ", 11) : -1;
+
+    if (f_separator == -1)
+    {
+      //doesn't look like the start of a message, so it's more of the last one
+      if (!f_messages.isEmpty())
+        f_messages.last().text.append("\n" + f_line);
+      continue;
+    }
+
+    //past midnight
+    if (f_time < f_previous)
+      f_date = f_date.addDays(1);
+    f_previous = f_time;
+
+    message f_message;
+    f_message.time = QDateTime(f_date, f_time).toMSecsSinceEpoch();
+    f_message.speaker = f_line.mid(11, f_separator - 11);
+    f_message.text = f_line.mid(f_separator + 2);
+    f_messages.append(f_message);
+  }
+
+  f_log.close();
+
+  return write_archive(p_archive, f_messages, quint64(f_info.size()), f_info.lastModified().toMSecsSinceEpoch());
+}
+
+bool AOChatArchive::write_archive(QString p_archive, const QVector<message> &p_messages,
+                                  quint64 p_source_size, qint64 p_source_time)
+{
+  QStringList f_speakers;
+  QHash<QString, quint32> f_speaker_ids;
+  QVector<quint32> f_message_speakers;
+  QVector<qint64> f_times;
+  QHash<QString, QVector<quint32>> f_postings;
+
+  QByteArray f_blocks;
+  QVector<quint64> f_offsets;
+  QVector<quint32> f_stored_sizes;
+  QVector<quint32> f_raw_sizes;
+
+  for (int n_first = 0 ; n_first < p_messages.size() ; n_first += block_messages)
+  {
+    QStringList f_texts;
+
+    for (int n_message = n_first ; n_message < qMin(n_first + block_messages, p_messages.size()) ; ++n_message)
+    {
+      const message &f_message = p_messages.at(n_message);
+
+      if (!f_speaker_ids.contains(f_message.speaker))
+      {
+        f_speaker_ids.insert(f_message.speaker, quint32(f_speakers.size()));
+        f_speakers.append(f_message.speaker);
+      }
+
+      f_message_speakers.append(f_speaker_ids.value(f_message.speaker));
+      f_times.append(f_message.time);
+
+      //a message is in a word's list once, however often it says it
+      QSet<QString> f_seen;
+      for (QString f_token : tokenize(f_message.text))
+      {
+        if (f_seen.contains(f_token))
+          continue;
+
+        f_seen.insert(f_token);
+        f_postings[f_token].append(quint32(n_message));
+      }
+
+      //'\0' separates the texts, it can't be in one
+      QString f_text = f_message.text;
+      f_texts.append(f_text.remove(QChar('\0')));
+    }
+
+    QByteArray f_raw = f_texts.join(QChar('\0')).toUtf8();
+    QByteArray f_stored = lz4_compress(f_raw.constData(), f_raw.size());
+
+    f_offsets.append(quint64(header_size + f_blocks.size()));
+    f_stored_sizes.append(quint32(f_stored.size()));
+    f_raw_sizes.append(quint32(f_raw.size()));
+    f_blocks.append(f_stored);
+  }
+
+  QByteArray f_index;
+  {
+    QDataStream f_out(&f_index, QIODevice::WriteOnly);
+    f_out.setVersion(QDataStream::Qt_5_7);
+    f_out << f_speakers << f_message_speakers << f_times << f_offsets << f_stored_sizes << f_raw_sizes << f_postings;
+  }
+  f_index = qCompress(f_index);
+
+  uchar f_header[header_size];
+  memset(f_header, 0, header_size);
+  memcpy(f_header, "AOCA", 4);
+  qToLittleEndian<quint32>(archive_version, f_header + 4);
+  qToLittleEndian<quint32>(quint32(p_messages.size()), f_header + 8);
+  qToLittleEndian<quint32>(quint32(f_offsets.size()), f_header + 12);
+  qToLittleEndian<quint64>(quint64(header_size + f_blocks.size()), f_header + 16);
+  qToLittleEndian<quint64>(quint64(f_index.size()), f_header + 24);
+  qToLittleEndian<quint64>(p_source_size, f_header + 32);
+  qToLittleEndian<qint64>(p_source_time, f_header + 40);
+
+  QFileInfo(p_archive).absoluteDir().mkpath(".");
+
+  QSaveFile f_file(p_archive);
+  if (!f_file.open(QIODevice::WriteOnly))
+  {
+    qDebug() << "Couldn't open" << p_archive;
+    return false;
+  }
+
+  f_file.write(reinterpret_cast<const char*>(f_header), header_size);
+  f_file.write(f_blocks);
+  f_file.write(f_index);
+
+  if (!f_file.commit())
+  {
+    qDebug() << "Couldn't write" << p_archive << f_file.errorString();
+    return false;
+  }
+
+  return true;
+}
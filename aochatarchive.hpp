@@ -0,0 +1,97 @@
+#ifndef AOCHATARCHIVE_HPP
+#define AOCHATARCHIVE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @brief The AOChatArchive is a searchable copy of one IC transcript.
+ * The messages are stored in LZ4 blocks, and an index with the speaker and time of every
+ * message and the messages every word appears in is kept in memory once the archive is
+ * opened. A search is a few hash lookups and a merge of sorted lists, only the blocks of
+ * messages that are actually shown get decompressed.
+ *
+ * Layout, all integers little-endian:
+ *   header  magic "AOCA", version, message count, block count, index offset, index size,
+ *           size and modification time of the transcript it was made from
+ *   blocks  the texts of up to block_messages messages, UTF-8 separated by '\0'
+ *   index   qCompress'd QDataStream of the speakers, every message's speaker and time,
+ *           the block table and the postings
+ */
+
+class AOChatArchive
+{
+public:
+  struct message
+  {
+    //ms since epoch
+    qint64 time = 0;
+    QString speaker;
+    QString text;
+  };
+
+  AOChatArchive();
+
+  //Reads the index of p_file. Returns false if it's missing or malformed
+  bool open(QString p_file);
+  void close();
+  bool is_open() {return m_file.isOpen();}
+
+  //Returns false if p_source was changed after the archive was made from it
+  bool is_current(QString p_source);
+
+  int get_message_count() {return m_times.size();}
+  //ms since epoch, 0 if it's empty
+  qint64 get_last_time() {return m_times.isEmpty() ? 0 : m_times.last();}
+
+  //Returns the ids of the messages containing every one of p_tokens, said by p_speaker unless
+  //it's empty, oldest first. Tokens come from tokenize()
+  QVector<quint32> search(QStringList p_tokens, QString p_speaker);
+
+  message read_message(quint32 p_id);
+
+  //Parses the transcript at p_source and writes its archive to p_archive
+  static bool import_text_log(QString p_source, QString p_archive);
+
+  //Lowercase words, same split for indexing and searching
+  static QStringList tokenize(QString p_text);
+
+  //Returns where the archive of the transcript at p_source belongs
+  static QString get_archive_path(QString p_source);
+
+  static const quint32 archive_version = 1;
+  static const int header_size = 48;
+  static const int block_messages = 256;
+
+private:
+  struct block
+  {
+    quint64 offset = 0;
+    quint32 stored_size = 0;
+    quint32 raw_size = 0;
+  };
+
+  QFile m_file;
+  quint64 m_source_size = 0;
+  qint64 m_source_time = 0;
+
+  QStringList m_speakers;
+  QVector<quint32> m_speaker_ids;
+  QVector<qint64> m_times;
+  QVector<block> m_blocks;
+  //token -> ids of the messages it's in, ascending
+  QHash<QString, QVector<quint32>> m_postings;
+
+  //the last block read, results are usually shown in order
+  int m_cached_block = -1;
+  QStringList m_cached_texts;
+
+  static bool write_archive(QString p_archive, const QVector<message> &p_messages,
+                            quint64 p_source_size, qint64 p_source_time);
+};
+
+#endif // AOCHATARCHIVE_HPP
@@ -0,0 +1,205 @@
+#include "aochatsearch.hpp"
+
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QDir>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QElapsedTimer>
+
+#include <algorithm>
+
+class AOChatImportTask : public QRunnable
+{
+public:
+  AOChatImportTask(QString p_directory, AOChatSearch *p_search)
+    : m_directory(p_directory), m_search(p_search) {}
+
+  void run()
+  {
+    int f_imported = 0;
+
+    for (QFileInfo f_log : QDir(m_directory).entryInfoList(QStringList{"*.txt"}, QDir::Files))
+    {
+      QString f_archive_path = AOChatArchive::get_archive_path(f_log.absoluteFilePath());
+
+      AOChatArchive f_archive;
+      if (f_archive.open(f_archive_path) && f_archive.is_current(f_log.absoluteFilePath()))
+        continue;
+      f_archive.close();
+
+      if (AOChatArchive::import_text_log(f_log.absoluteFilePath(), f_archive_path))
+        ++f_imported;
+    }
+
+    QMetaObject::invokeMethod(m_search, "on_import_finished", Qt::QueuedConnection, Q_ARG(int, f_imported));
+  }
+
+private:
+  QString m_directory;
+  AOChatSearch *m_search;
+};
+
+AOChatSearch::AOChatSearch(QString p_log_directory, QWidget *p_parent) : QWidget(p_parent, Qt::Window)
+{
+  m_directory = p_log_directory;
+
+  m_pool.setMaxThreadCount(1);
+
+  setWindowTitle("Search logs");
+  resize(640, 480);
+
+  ui_query = new QLineEdit(this);
+  ui_query->setPlaceholderText("Words");
+  ui_speaker = new QLineEdit(this);
+  ui_speaker->setPlaceholderText("Speaker");
+  ui_import = new QPushButton("Import logs", this);
+  ui_results = new QListWidget(this);
+  ui_results->setWordWrap(true);
+  ui_status = new QLabel(this);
+
+  QHBoxLayout *f_fields = new QHBoxLayout();
+  f_fields->addWidget(ui_query, 3);
+  f_fields->addWidget(ui_speaker, 1);
+  f_fields->addWidget(ui_import);
+
+  QVBoxLayout *f_layout = new QVBoxLayout(this);
+  f_layout->addLayout(f_fields);
+  f_layout->addWidget(ui_results);
+  f_layout->addWidget(ui_status);
+
+  connect(ui_query, SIGNAL(textChanged(QString)), this, SLOT(on_search()));
+  connect(ui_speaker, SIGNAL(textChanged(QString)), this, SLOT(on_search()));
+  connect(ui_import, SIGNAL(clicked()), this, SLOT(on_import_clicked()));
+}
+
+AOChatSearch::~AOChatSearch()
+{
+  m_pool.waitForDone();
+  close_archives();
+}
+
+void AOChatSearch::set_query(QString p_query)
+{
+  ui_query->setText(p_query);
+  //textChanged doesn't fire if it's the same text, the archives may have changed though
+  on_search();
+}
+
+void AOChatSearch::load_archives()
+{
+  QHash<QString, archive> f_archives;
+
+  QDir f_dir(m_directory + "archive");
+  for (QFileInfo f_file : f_dir.entryInfoList(QStringList{"*.aoca"}, QDir::Files))
+  {
+    QString f_path = f_file.absoluteFilePath();
+    archive f_archive = m_archives.take(f_path);
+
+    if (f_archive.file && f_archive.modified == f_file.lastModified())
+    {
+      f_archives.insert(f_path, f_archive);
+      continue;
+    }
+
+    delete f_archive.file;
+    f_archive.file = new AOChatArchive();
+    f_archive.modified = f_file.lastModified();
+
+    if (!f_archive.file->open(f_path))
+    {
+      delete f_archive.file;
+      continue;
+    }
+
+    f_archives.insert(f_path, f_archive);
+  }
+
+  //whatever is left got deleted
+  close_archives();
+  m_archives = f_archives;
+
+  m_order = m_archives.keys();
+  std::sort(m_order.begin(), m_order.end(), [this](const QString &a, const QString &b)
+  {
+    return m_archives.value(a).file->get_last_time() > m_archives.value(b).file->get_last_time();
+  });
+}
+
+void AOChatSearch::close_archives()
+{
+  for (const archive &f_archive : m_archives)
+    delete f_archive.file;
+
+  m_archives.clear();
+  m_order.clear();
+}
+
+void AOChatSearch::on_search()
+{
+  ui_results->clear();
+
+  QStringList f_tokens = AOChatArchive::tokenize(ui_query->text());
+  QString f_speaker = ui_speaker->text().trimmed();
+
+  if (f_tokens.isEmpty() && f_speaker.isEmpty())
+  {
+    ui_status->setText("");
+    return;
+  }
+
+  //the archives are being rewritten, on_import_finished searches again
+  if (!ui_import->isEnabled())
+    return;
+
+  QElapsedTimer f_timer;
+  f_timer.start();
+
+  load_archives();
+
+  int f_found = 0;
+  QStringList f_lines;
+
+  for (QString f_path : m_order)
+  {
+    AOChatArchive *f_archive = m_archives.value(f_path).file;
+    QVector<quint32> f_ids = f_archive->search(f_tokens, f_speaker);
+
+    f_found += f_ids.size();
+
+    //newest first
+    for (int n_id = f_ids.size() - 1 ; n_id >= 0 && f_lines.size() < max_results ; --n_id)
+    {
+      AOChatArchive::message f_message = f_archive->read_message(f_ids.at(n_id));
+      f_lines.append("[" + QDateTime::fromMSecsSinceEpoch(f_message.time).toString("yyyy-MM-dd hh:mm:ss") + "] " +
+                     f_message.speaker + ": " + f_message.text);
+    }
+  }
+
+  ui_results->addItems(f_lines);
+
+  ui_status->setText(QString::number(f_found) + " messages in " + QString::number(m_archives.size()) +
+                     " logs (" + QString::number(f_timer.elapsed()) + " ms)" +
+                     (f_found > max_results ? ", showing the newest " + QString::number(max_results) : ""));
+}
+
+void AOChatSearch::on_import_clicked()
+{
+  //archives being rewritten can't be held open
+  close_archives();
+
+  ui_import->setEnabled(false);
+  ui_status->setText("Importing...");
+
+  m_pool.start(new AOChatImportTask(m_directory, this));
+}
+
+void AOChatSearch::on_import_finished(int p_imported)
+{
+  ui_import->setEnabled(true);
+
+  on_search();
+
+  if (ui_status->text() == "")
+    ui_status->setText("Imported " + QString::number(p_imported) + " logs");
+}
@@ -0,0 +1,65 @@
+#ifndef AOCHATSEARCH_HPP
+#define AOCHATSEARCH_HPP
+
+#include "aochatarchive.hpp"
+
+#include <QWidget>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QListWidget>
+#include <QLabel>
+#include <QHash>
+#include <QDateTime>
+#include <QThreadPool>
+
+/**
+ * @brief The AOChatSearch is the window /logsearch opens.
+ * It searches the archives of every finished IC transcript under logs/ as you type, newest
+ * messages first, and can import the .txt logs that have no archive yet.
+ */
+
+class AOChatSearch : public QWidget
+{
+  Q_OBJECT
+
+public:
+  AOChatSearch(QString p_log_directory, QWidget *p_parent = nullptr);
+  ~AOChatSearch();
+
+  void set_query(QString p_query);
+
+private:
+  QString m_directory;
+
+  QLineEdit *ui_query;
+  QLineEdit *ui_speaker;
+  QPushButton *ui_import;
+  QListWidget *ui_results;
+  QLabel *ui_status;
+
+  struct archive
+  {
+    AOChatArchive *file = nullptr;
+    QDateTime modified;
+  };
+
+  //archive path -> the open archive, the newest ones first once they're loaded
+  QHash<QString, archive> m_archives;
+  QStringList m_order;
+
+  //imports run here, one at a time
+  QThreadPool m_pool;
+
+  const int max_results = 500;
+
+  //Opens archives that are new or changed and forgets the ones that are gone
+  void load_archives();
+  void close_archives();
+
+private slots:
+  void on_search();
+  void on_import_clicked();
+  void on_import_finished(int p_imported);
+};
+
+#endif // AOCHATSEARCH_HPP
@@ -15,20 +15,23 @@ AOEmoteButton::AOEmoteButton(QWidget *p_parent, AOApplication *p_ao_app, int p_x
 
 void AOEmoteButton::set_image(QString p_char, int p_emote, QString suffix)
 {
+  AOAssetResolver *resolver = ao_app->asset_resolver;
+  int char_layer = resolver->get_layer_set({"character:" + p_char});
   QString emotion_number = QString::number(p_emote + 1);
-  QString image_path = ao_app->get_character_path(p_char) + "emotions/ao2/button" + emotion_number + suffix;
-  QString alt_path = ao_app->get_character_path(p_char) + "emotions/button" + emotion_number + suffix;
-  QString hover_path = ao_app->get_character_path(p_char) + "emotions/hovers/button" + emotion_number + "_hover" + suffix;
+  QString image_path = resolver->resolve(char_layer, "emotions/ao2/button" + emotion_number + suffix);
+  QString alt_path;
 
-  if (file_exists(image_path))
+  if (image_path != "")
   {
     this->setText("");
     this->setStyleSheet("border-image:url(\"" + image_path + "\")");
   }
-  else if (file_exists(alt_path))
+  else if ((alt_path = resolver->resolve(char_layer, "emotions/button" + emotion_number + suffix)) != "")
   {
+    QString hover_path = resolver->resolve(char_layer, "emotions/hovers/button" + emotion_number + "_hover" + suffix);
+
     this->setText("");
-    if(file_exists(hover_path))
+    if(hover_path != "")
     {
       this->setStyleSheet("QPushButton {border-image:url(\"" + alt_path + "\");}"
             "QPushButton:hover {border-image:url(\"" + hover_path + "\");}");
@@ -4,17 +4,18 @@
 
 #include "file_functions.h"
 #include "datatypes.h"
-#include "misc_functions.h"
+#include "aoviewport.hpp"
 
 AOEvidenceDisplay::AOEvidenceDisplay(QWidget *p_parent, AOApplication *p_ao_app) : QLabel(p_parent)
 {
   ao_app = p_ao_app;
 
-  evidence_movie = new QMovie(this);
+  evidence_player = new AOFramePlayer(this, ao_app);
+  evidence_player->set_play_once(true);
   evidence_icon = new QLabel(this);
   sfx_player = new AOSfxPlayer(this, ao_app);
 
-  connect(evidence_movie, SIGNAL(frameChanged(int)), this, SLOT(frame_change(int)));
+  connect(evidence_player, SIGNAL(finished()), this, SLOT(on_finished()));
 }
 
 void AOEvidenceDisplay::show_evidence(QString p_evidence_image, bool is_left_side, int p_volume)
@@ -25,7 +26,7 @@ void AOEvidenceDisplay::show_evidence(QString p_evidence_image, bool is_left_sid
 
   QString f_evidence_path = ao_app->get_evidence_path() + p_evidence_image;
 
-  QPixmap f_pixmap(f_evidence_path);
+  QPixmap f_pixmap = load_pixmap(f_evidence_path);
 
   QString final_gif_path;
   QString gif_name;
@@ -57,37 +58,28 @@ void AOEvidenceDisplay::show_evidence(QString p_evidence_image, bool is_left_sid
   else
     final_gif_path = f_default_gif_path;
 
-  evidence_movie->setFileName(final_gif_path);
-
-  if(evidence_movie->frameCount() < 1)
+  if (!file_exists(final_gif_path))
     return;
 
-  this->setMovie(evidence_movie);
-
-  evidence_movie->start();
+  //the gif is shown at its own size
+  evidence_player->play(final_gif_path, QSize());
   sfx_player->play(ao_app->get_sfx("evidence_present"));
 }
 
-void AOEvidenceDisplay::frame_change(int p_frame)
+void AOEvidenceDisplay::on_finished()
 {
-  if (p_frame == (evidence_movie->frameCount() - 1))
-  {
-    //we need this or else the last frame wont show
-    delay(evidence_movie->nextFrameDelay());
+  evidence_player->stop();
+  AOViewport::clear_pixmap(this);
 
-    evidence_movie->stop();
-    this->clear();
-
-    evidence_icon->show();
-  }
+  evidence_icon->show();
 }
 
 void AOEvidenceDisplay::reset()
 {
   sfx_player->stop();
-  evidence_movie->stop();
+  evidence_player->stop();
   evidence_icon->hide();
-  this->clear();
+  AOViewport::clear_pixmap(this);
 }
 
 QLabel* AOEvidenceDisplay::get_evidence_icon()
@@ -2,10 +2,10 @@
 #define AOEVIDENCEDISPLAY_H
 
 #include <QLabel>
-#include <QMovie>
 
 #include "aoapplication.h"
 #include "aosfxplayer.h"
+#include "aoframeplayer.hpp"
 
 class AOEvidenceDisplay : public QLabel
 {
@@ -20,12 +20,12 @@ public:
 
 private:
   AOApplication *ao_app = nullptr;
-  QMovie *evidence_movie;
+  AOFramePlayer *evidence_player;
   QLabel *evidence_icon;
   AOSfxPlayer *sfx_player;
 
 private slots:
-  void frame_change(int p_frame);
+  void on_finished();
 };
 
 #endif // AOEVIDENCEDISPLAY_H
@@ -0,0 +1,380 @@
+#include "aofilewriter.hpp"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QStringList>
+#include <QRunnable>
+#include <QMutexLocker>
+#include <QDebug>
+
+class AOFileWriteTask : public QRunnable
+{
+public:
+  AOFileWriteTask(AOFileWriter *p_writer) : m_writer(p_writer) {}
+
+  void run() { m_writer->write_pending(); }
+
+private:
+  AOFileWriter *m_writer;
+};
+
+AOFileWriter::AOFileWriter(QObject *p_parent) : QObject(p_parent)
+{
+  m_pool.setMaxThreadCount(1);
+
+  m_debounce_timer = new QTimer(this);
+  m_debounce_timer->setSingleShot(true);
+  m_debounce_timer->setInterval(debounce_time);
+
+  connect(m_debounce_timer, SIGNAL(timeout()), this, SLOT(on_debounce_timeout()));
+}
+
+AOFileWriter::~AOFileWriter()
+{
+  //whatever is still queued has to make it to the disk before we go
+  flush();
+}
+
+void AOFileWriter::write_file(QString p_file, QByteArray p_contents)
+{
+  {
+    QMutexLocker locker(&m_state_mutex);
+
+    pending_file &f_pending = m_pending[p_file];
+    f_pending.replace = true;
+    f_pending.contents = p_contents;
+    //earlier edits are overwritten by the new contents anyway
+    f_pending.edits.clear();
+  }
+
+  schedule_write();
+}
+
+void AOFileWriter::append_to_file(QString p_file, QByteArray p_data)
+{
+  {
+    QMutexLocker locker(&m_state_mutex);
+
+    pending_file &f_pending = m_pending[p_file];
+
+    //consecutive appends are merged into one
+    if (!f_pending.edits.isEmpty() && !f_pending.edits.last().is_ini_value)
+      f_pending.edits.last().data.append(p_data);
+    else
+    {
+      file_edit f_edit;
+      f_edit.data = p_data;
+      f_pending.edits.append(f_edit);
+    }
+  }
+
+  schedule_write();
+}
+
+void AOFileWriter::set_ini_value(QString p_file, QString p_key, QString p_value)
+{
+  {
+    QMutexLocker locker(&m_state_mutex);
+
+    pending_file &f_pending = m_pending[p_file];
+
+    //only the last value of a key matters
+    for (int n_edit = f_pending.edits.size() - 1 ; n_edit >= 0 ; --n_edit)
+    {
+      if (f_pending.edits.at(n_edit).is_ini_value && f_pending.edits.at(n_edit).key == p_key)
+        f_pending.edits.remove(n_edit);
+    }
+
+    file_edit f_edit;
+    f_edit.is_ini_value = true;
+    f_edit.key = p_key;
+    f_edit.value = p_value;
+    f_pending.edits.append(f_edit);
+  }
+
+  schedule_write();
+}
+
+bool AOFileWriter::get_pending_contents(QString p_file, QByteArray &p_contents)
+{
+  QMutexLocker locker(&m_state_mutex);
+
+  //the queued edits are newer than the batch on its way to the disk
+  if (m_pending.contains(p_file))
+    return find_pending_contents(m_pending, p_file, p_contents);
+
+  return find_pending_contents(m_writing, p_file, p_contents);
+}
+
+bool AOFileWriter::find_pending_contents(const QHash<QString, pending_file> &p_files, QString p_file,
+                                         QByteArray &p_contents)
+{
+  QHash<QString, pending_file>::const_iterator f_pending = p_files.constFind(p_file);
+  if (f_pending == p_files.constEnd() || !f_pending.value().replace || !f_pending.value().edits.isEmpty())
+    return false;
+
+  p_contents = f_pending.value().contents;
+  return true;
+}
+
+bool AOFileWriter::get_pending_ini_value(QString p_file, QString p_key, QString &p_value)
+{
+  QMutexLocker locker(&m_state_mutex);
+
+  //the queued edits first, then the batch on its way to the disk
+  for (const QHash<QString, pending_file> *f_files : {&m_pending, &m_writing})
+  {
+    QHash<QString, pending_file>::const_iterator f_pending = f_files->constFind(p_file);
+    if (f_pending == f_files->constEnd())
+      continue;
+
+    const QVector<file_edit> &f_edits = f_pending.value().edits;
+    for (int n_edit = f_edits.size() - 1 ; n_edit >= 0 ; --n_edit)
+    {
+      if (f_edits.at(n_edit).is_ini_value && f_edits.at(n_edit).key == p_key)
+      {
+        p_value = f_edits.at(n_edit).value;
+        return true;
+      }
+    }
+
+    //a full rewrite hides whatever came before it
+    if (f_pending.value().replace)
+      return false;
+  }
+
+  return false;
+}
+
+QByteArray AOFileWriter::read_file(QString p_file)
+{
+  for (;;)
+  {
+    quint64 f_generation;
+    bool is_in_flight;
+    file_write f_in_flight;
+    pending_file f_writing;
+    pending_file f_pending;
+    bool has_writing;
+    bool has_pending;
+
+    {
+      QMutexLocker locker(&m_state_mutex);
+
+      f_generation = m_generation;
+      is_in_flight = m_in_flight.contains(p_file);
+      f_in_flight = m_in_flight.value(p_file);
+      has_writing = m_writing.contains(p_file);
+      f_writing = m_writing.value(p_file);
+      has_pending = m_pending.contains(p_file);
+      f_pending = m_pending.value(p_file);
+    }
+
+    QByteArray f_contents;
+    bool read_disk = !is_in_flight || !f_in_flight.replace;
+
+    if (read_disk)
+    {
+      QFile f_file(p_file);
+      if (f_file.open(QIODevice::ReadOnly))
+        f_contents = f_file.readAll();
+    }
+
+    if (is_in_flight)
+    {
+      //an append may or may not have hit the disk yet, cutting it off first counts it once either way
+      if (f_in_flight.replace)
+        f_contents = f_in_flight.contents;
+      else
+        f_contents = f_contents.left(int(f_in_flight.base_size)) + f_in_flight.contents;
+    }
+    else if (has_writing)
+      apply_edits(f_contents, f_writing);
+
+    //what was queued after the batch on its way to the disk
+    if (has_pending)
+      apply_edits(f_contents, f_pending);
+
+    if (!read_disk)
+      return f_contents;
+
+    //a write started or finished while we were reading, what we read may not match the queues
+    QMutexLocker locker(&m_state_mutex);
+    if (f_generation == m_generation)
+      return f_contents;
+  }
+}
+
+void AOFileWriter::start_write()
+{
+  m_debounce_timer->stop();
+  m_pool.start(new AOFileWriteTask(this));
+}
+
+void AOFileWriter::flush()
+{
+  m_debounce_timer->stop();
+
+  //let a write that is already running finish first, then do the rest ourselves
+  m_pool.waitForDone();
+  write_pending();
+}
+
+void AOFileWriter::schedule_write()
+{
+  if (!m_debounce_timer->isActive())
+  {
+    m_pending_age.start();
+    m_debounce_timer->start();
+  }
+  else if (m_pending_age.elapsed() < max_write_delay)
+  {
+    //restarts the countdown
+    m_debounce_timer->start();
+  }
+}
+
+void AOFileWriter::on_debounce_timeout()
+{
+  m_pool.start(new AOFileWriteTask(this));
+}
+
+void AOFileWriter::write_pending()
+{
+  QMutexLocker io_locker(&m_io_mutex);
+
+  QHash<QString, pending_file> f_batch;
+
+  {
+    QMutexLocker state_locker(&m_state_mutex);
+    //stays readable through m_writing until every file of it is committed
+    m_writing = m_pending;
+    m_pending.clear();
+    f_batch = m_writing;
+  }
+
+  QHash<QString, pending_file>::const_iterator f_file = f_batch.constBegin();
+  for ( ; f_file != f_batch.constEnd() ; ++f_file)
+    write_one(f_file.key(), f_file.value());
+
+  QMutexLocker state_locker(&m_state_mutex);
+  m_writing.clear();
+}
+
+void AOFileWriter::write_one(QString p_file, const pending_file &p_edits)
+{
+  bool is_append = !p_edits.replace;
+  for (const file_edit &f_edit : p_edits.edits)
+    is_append = is_append && !f_edit.is_ini_value;
+
+  if (is_append)
+  {
+    //the data is written as it is, the callers pick their line endings
+    QFile f_out(p_file);
+    if (!f_out.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+      qDebug() << "Couldn't open" << p_file;
+      end_write(p_file);
+      return;
+    }
+
+    file_write f_write;
+    f_write.base_size = f_out.size();
+    for (const file_edit &f_edit : p_edits.edits)
+      f_write.contents.append(f_edit.data);
+
+    begin_write(p_file, f_write);
+    f_out.write(f_write.contents);
+    f_out.close();
+    end_write(p_file);
+    return;
+  }
+
+  file_write f_write;
+  f_write.replace = true;
+
+  if (!p_edits.replace)
+  {
+    QFile f_old(p_file);
+    if (f_old.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+      f_write.contents = f_old.readAll();
+      f_old.close();
+    }
+  }
+
+  apply_edits(f_write.contents, p_edits);
+
+  QSaveFile f_out(p_file);
+  if (!f_out.open(QIODevice::WriteOnly | QIODevice::Text))
+  {
+    qDebug() << "Couldn't open" << p_file;
+    end_write(p_file);
+    return;
+  }
+
+  begin_write(p_file, f_write);
+
+  f_out.write(f_write.contents);
+
+  //renames the temporary file over the real one, the old contents stay intact if anything failed
+  if (!f_out.commit())
+    qDebug() << "Couldn't write" << p_file << f_out.errorString();
+
+  end_write(p_file);
+}
+
+void AOFileWriter::begin_write(QString p_file, const file_write &p_write)
+{
+  QMutexLocker state_locker(&m_state_mutex);
+
+  m_in_flight.insert(p_file, p_write);
+  ++m_generation;
+}
+
+void AOFileWriter::end_write(QString p_file)
+{
+  QMutexLocker state_locker(&m_state_mutex);
+
+  m_in_flight.remove(p_file);
+  m_writing.remove(p_file);
+  ++m_generation;
+}
+
+void AOFileWriter::apply_edits(QByteArray &p_contents, const pending_file &p_edits)
+{
+  if (p_edits.replace)
+    p_contents = p_edits.contents;
+
+  for (const file_edit &f_edit : p_edits.edits)
+  {
+    if (f_edit.is_ini_value)
+      apply_ini_value(p_contents, f_edit.key, f_edit.value);
+    else
+      p_contents.append(f_edit.data);
+  }
+}
+
+void AOFileWriter::apply_ini_value(QByteArray &p_contents, QString p_key, QString p_value)
+{
+  QStringList f_lines = QString::fromLocal8Bit(p_contents).split("\n");
+
+  //split leaves an empty element behind the last newline
+  if (!f_lines.isEmpty() && f_lines.last() == "")
+    f_lines.removeLast();
+
+  for (QString &f_line : f_lines)
+  {
+    if (!f_line.startsWith(p_key))
+      continue;
+
+    QStringList line_elements = f_line.split("=");
+
+    if (line_elements.at(0).trimmed() != p_key || line_elements.size() < 2)
+      continue;
+
+    f_line = p_key + " = " + p_value;
+  }
+
+  p_contents = (f_lines.join("\n") + "\n").toLocal8Bit();
+}
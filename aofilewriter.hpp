@@ -0,0 +1,125 @@
+#ifndef AOFILEWRITER_HPP
+#define AOFILEWRITER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QThreadPool>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class AOFileWriteTask;
+
+/**
+ * @brief The AOFileWriter persists config and note files off the GUI thread.
+ * Edits are queued and merged per file, and after a short debounce they are
+ * written on a background thread. Rewrites go to a temporary file that is renamed
+ * over the target, so a crash can never leave a half-written file behind. Files
+ * that only got appended to are appended to in place.
+ */
+
+class AOFileWriter : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOFileWriter(QObject *p_parent = nullptr);
+  ~AOFileWriter();
+
+  //Replaces the whole contents of p_file
+  void write_file(QString p_file, QByteArray p_contents);
+
+  //Appends p_data to the end of p_file
+  void append_to_file(QString p_file, QByteArray p_data);
+
+  //Sets "p_key = p_value" in the ini file p_file. Nothing is added if the key is missing
+  void set_ini_value(QString p_file, QString p_key, QString p_value);
+
+  //Returns true and fills p_contents if a full rewrite of p_file is waiting to be written
+  bool get_pending_contents(QString p_file, QByteArray &p_contents);
+
+  //Returns true and fills p_value if a new value for p_key in p_file is waiting to be written
+  bool get_pending_ini_value(QString p_file, QString p_key, QString &p_value);
+
+  //Returns p_file as it will be once every queued edit is written, without waiting for that
+  QByteArray read_file(QString p_file);
+
+  //Starts writing every pending edit in the background without waiting for the debounce
+  void start_write();
+
+  //Writes every pending edit right away on the calling thread
+  void flush();
+
+private:
+  struct file_edit
+  {
+    //true for "key = value" edits, false for appends
+    bool is_ini_value = false;
+    QString key;
+    QString value;
+    QByteArray data;
+  };
+
+  struct pending_file
+  {
+    bool replace = false;
+    QByteArray contents;
+    QVector<file_edit> edits;
+  };
+
+  //how long the file has to stay untouched before we write it
+  const int debounce_time = 500;
+  //edits never wait longer than this, even if they keep coming
+  const int max_write_delay = 3000;
+
+  //what write_one is putting on the disk right now
+  struct file_write
+  {
+    //true if contents is the whole file, false if it's appended at base_size
+    bool replace = false;
+    QByteArray contents;
+    qint64 base_size = 0;
+  };
+
+  //guards m_pending, m_writing, m_in_flight and m_generation. Never held across disk I/O
+  QMutex m_state_mutex;
+  //held for the whole write so that batches hit the disk in the order they were taken
+  QMutex m_io_mutex;
+
+  QHash<QString, pending_file> m_pending;
+  //the batch being written right now, readers still see it until it's on the disk
+  QHash<QString, pending_file> m_writing;
+  //the files of m_writing whose write has started, so readers know what the disk ends up holding
+  QHash<QString, file_write> m_in_flight;
+  //bumped whenever a write starts or ends, readers that went to the disk in between try again
+  quint64 m_generation = 0;
+
+  QTimer *m_debounce_timer;
+  QElapsedTimer m_pending_age;
+
+  //a single thread, so writes never race each other
+  QThreadPool m_pool;
+
+  void schedule_write();
+  void write_one(QString p_file, const pending_file &p_edits);
+  void begin_write(QString p_file, const file_write &p_write);
+  void end_write(QString p_file);
+
+  //writes everything that is currently queued, called by the pool thread and by flush()
+  void write_pending();
+
+  static bool find_pending_contents(const QHash<QString, pending_file> &p_files, QString p_file,
+                                    QByteArray &p_contents);
+  static void apply_edits(QByteArray &p_contents, const pending_file &p_edits);
+  static void apply_ini_value(QByteArray &p_contents, QString p_key, QString p_value);
+
+  friend class AOFileWriteTask;
+
+private slots:
+  void on_debounce_timeout();
+};
+
+#endif // AOFILEWRITER_HPP
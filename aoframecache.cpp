@@ -0,0 +1,300 @@
+#include "aoframecache.hpp"
+
+#include "file_functions.h"
+#include "aoblit.hpp"
+#include "aoassetindex.hpp"
+
+#include <QImageReader>
+#include <QScopedPointer>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QMetaObject>
+#include <QDebug>
+
+class AOFrameDecodeTask : public QRunnable
+{
+public:
+  AOFrameDecodeTask(AOFrameCache *p_cache, frame_set_ptr p_frames, QString p_path, bool p_flipped, QSize p_size)
+    : m_cache(p_cache), m_frames(p_frames), m_path(p_path), m_flipped(p_flipped), m_size(p_size) {}
+
+  void run() { m_cache->decode(m_frames, m_path, m_flipped, m_size); }
+
+private:
+  AOFrameCache *m_cache;
+  frame_set_ptr m_frames;
+  QString m_path;
+  bool m_flipped;
+  QSize m_size;
+};
+
+int AOFrameSet::frame_count()
+{
+  QMutexLocker locker(&mutex);
+  return delays.size();
+}
+
+int AOFrameSet::get_delay(int n_frame)
+{
+  QMutexLocker locker(&mutex);
+  return delays.value(n_frame, 0);
+}
+
+QRect AOFrameSet::get_opaque(int n_frame)
+{
+  QMutexLocker locker(&mutex);
+  return opaque.value(n_frame);
+}
+
+bool AOFrameSet::is_finished()
+{
+  QMutexLocker locker(&mutex);
+  return finished;
+}
+
+AOFrameCache::AOFrameCache(QObject *p_parent) : QObject(p_parent)
+{
+  m_cache.setMaxCost(byte_budget);
+}
+
+AOFrameCache::~AOFrameCache()
+{
+  m_abort.store(1);
+  m_pool.waitForDone();
+}
+
+frame_set_ptr AOFrameCache::get_frames(QString p_path, bool p_flipped, QSize p_size)
+{
+  QString f_key = get_key(p_path, p_flipped, p_size);
+
+  QMutexLocker locker(&m_mutex);
+
+  frame_set_ptr *f_cached = m_cache.object(f_key);
+  if (f_cached != nullptr)
+  {
+    ++m_hits;
+    return *f_cached;
+  }
+
+  ++m_misses;
+
+  frame_set_ptr f_frames = std::make_shared<AOFrameSet>();
+  f_frames->key = f_key;
+  f_frames->path = p_path;
+
+  //the real cost is filled in when the decode is done
+  m_cache.insert(f_key, new frame_set_ptr(f_frames), 1);
+
+  m_pool.start(new AOFrameDecodeTask(this, f_frames, p_path, p_flipped, p_size));
+
+  return f_frames;
+}
+
+void AOFrameCache::acquire(const frame_set_ptr &p_frames)
+{
+  p_frames->players.ref();
+}
+
+void AOFrameCache::release(const frame_set_ptr &p_frames)
+{
+  if (p_frames->players.deref() || p_frames->is_finished())
+    return;
+
+  p_frames->cancelled.store(1);
+
+  //a half decoded set is no use to anyone, the next play starts over
+  QMutexLocker locker(&m_mutex);
+
+  frame_set_ptr *f_cached = m_cache.object(p_frames->key);
+  if (f_cached != nullptr && *f_cached == p_frames)
+    m_cache.remove(p_frames->key);
+}
+
+void AOFrameCache::clear()
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+  }
+
+  QMutexLocker locker(&m_container_mutex);
+  m_containers.clear();
+}
+
+void AOFrameCache::on_index_changed(QStringList p_changed)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+
+    for (const QString &f_key : m_cache.keys())
+    {
+      const QString &f_path = (*m_cache.object(f_key))->path;
+
+      //a container compiled or deleted next to it changes where the frames come from, too
+      if (AOAssetIndex::overlaps(f_path, p_changed) ||
+          AOAssetIndex::overlaps(AOFrameContainer::get_container_path(f_path), p_changed))
+        m_cache.remove(f_key);
+    }
+  }
+
+  QMutexLocker locker(&m_container_mutex);
+
+  for (QHash<QString, std::shared_ptr<AOFrameContainer>>::iterator it = m_containers.begin() ; it != m_containers.end() ;)
+  {
+    if (AOAssetIndex::overlaps(it.key(), p_changed))
+      it = m_containers.erase(it);
+    else
+      ++it;
+  }
+}
+
+qint64 AOFrameCache::get_bytes()
+{
+  QMutexLocker locker(&m_mutex);
+  return m_cache.totalCost();
+}
+
+void AOFrameCache::prepare_pixmaps(const frame_set_ptr &p_frames)
+{
+  QMutexLocker locker(&p_frames->mutex);
+
+  //the images are already in the native format, so the pixmaps just take over their memory
+  for (int n_frame = p_frames->pixmaps.size() ; n_frame < p_frames->frames.size() ; ++n_frame)
+    p_frames->pixmaps.append(QPixmap::fromImage(std::move(p_frames->frames[n_frame])));
+}
+
+QString AOFrameCache::get_key(QString p_path, bool p_flipped, QSize p_size)
+{
+  return p_path + (p_flipped ? "|f|" : "|n|") + QString::number(p_size.width()) + "x" + QString::number(p_size.height());
+}
+
+std::shared_ptr<AOFrameContainer> AOFrameCache::get_container(QString p_path)
+{
+  QString f_container_path = AOFrameContainer::get_container_path(p_path);
+
+  QMutexLocker locker(&m_container_mutex);
+
+  //misses are remembered too, most folders don't have one
+  if (m_containers.contains(f_container_path))
+    return m_containers.value(f_container_path);
+
+  std::shared_ptr<AOFrameContainer> f_container;
+
+  if (file_exists(f_container_path))
+  {
+    f_container = std::make_shared<AOFrameContainer>();
+
+    bool f_opened;
+    if (is_packed_asset(f_container_path))
+      f_opened = f_container->open_data(read_asset(f_container_path));
+    else
+      f_opened = f_container->open(f_container_path);
+
+    if (!f_opened)
+      f_container.reset();
+  }
+
+  m_containers.insert(f_container_path, f_container);
+  return f_container;
+}
+
+void AOFrameCache::add_frame(const frame_set_ptr &p_frames, QImage p_image, int p_delay, bool p_flipped, QSize p_size)
+{
+  //scaled, mirrored and in the format the raster engine blits fastest, in one go for whole-number scales
+  p_image = scale_frame(p_image, p_size, p_flipped);
+  QRect f_opaque = opaque_rect(p_image);
+
+  {
+    QMutexLocker locker(&p_frames->mutex);
+    p_frames->bytes += qint64(p_image.bytesPerLine()) * p_image.height();
+    p_frames->frames.append(p_image);
+    p_frames->delays.append(p_delay);
+    p_frames->opaque.append(f_opaque);
+  }
+
+  QMetaObject::invokeMethod(this, "frames_decoded", Qt::QueuedConnection, Q_ARG(QString, p_frames->key));
+}
+
+bool AOFrameCache::decode_container(frame_set_ptr p_frames, QString p_path, bool p_flipped, QSize p_size)
+{
+  std::shared_ptr<AOFrameContainer> f_container = get_container(p_path);
+  if (!f_container)
+    return false;
+
+  int f_animation = f_container->find(p_path.mid(p_path.lastIndexOf("/") + 1));
+  if (f_animation < 0)
+    return false;
+
+  //somebody edited the gif and didn't run aoc again
+  if (!f_container->is_current(f_animation, p_path))
+    return false;
+
+  m_container_decodes.ref();
+
+  for (int n_frame = 0 ; n_frame < f_container->get_frame_count(f_animation) ; ++n_frame)
+  {
+    if (p_frames->cancelled.load() || m_abort.load())
+      break;
+
+    QImage f_image = f_container->read_frame(f_animation, n_frame);
+    if (f_image.isNull())
+    {
+      qDebug() << "W: frame" << n_frame << "of" << p_path << "is broken in its container";
+      break;
+    }
+
+    add_frame(p_frames, f_image, f_container->get_delay(f_animation, n_frame), p_flipped, p_size);
+  }
+
+  return true;
+}
+
+void AOFrameCache::decode(frame_set_ptr p_frames, QString p_path, bool p_flipped, QSize p_size)
+{
+  //compiled by tools/aoc, no gif decoding needed
+  if (!decode_container(p_frames, p_path, p_flipped, p_size))
+  {
+    QScopedPointer<QIODevice> f_device(open_asset(p_path));
+    QScopedPointer<QImageReader> f_reader;
+
+    if (f_device)
+      f_reader.reset(new QImageReader(f_device.data()));
+
+    QImage f_image;
+    if (f_reader)
+      f_image = f_reader->read();
+
+    while (!f_image.isNull())
+    {
+      if (p_frames->cancelled.load() || m_abort.load())
+        break;
+
+      add_frame(p_frames, f_image, f_reader->nextImageDelay(), p_flipped, p_size);
+
+      f_image = f_reader->read();
+    }
+  }
+
+  qint64 f_bytes;
+
+  {
+    QMutexLocker locker(&p_frames->mutex);
+    p_frames->finished = true;
+    f_bytes = p_frames->bytes;
+  }
+
+  QMetaObject::invokeMethod(this, "frames_decoded", Qt::QueuedConnection, Q_ARG(QString, p_frames->key));
+
+  if (p_frames->cancelled.load())
+    return;
+
+  //now that we know how big it is, let the cache count it properly
+  QMutexLocker locker(&m_mutex);
+
+  frame_set_ptr *f_cached = m_cache.object(p_frames->key);
+  if (f_cached != nullptr && *f_cached == p_frames)
+  {
+    //QCache takes the cost as an int, anything this big wouldn't fit anyway
+    int f_cost = static_cast<int>(qMin<qint64>(f_bytes, byte_budget + 1));
+    m_cache.insert(p_frames->key, new frame_set_ptr(p_frames), qMax(1, f_cost));
+  }
+}
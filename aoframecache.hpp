@@ -0,0 +1,130 @@
+#ifndef AOFRAMECACHE_HPP
+#define AOFRAMECACHE_HPP
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QRect>
+#include <QImage>
+#include <QPixmap>
+#include <QVector>
+#include <QCache>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QThreadPool>
+#include <QHash>
+
+#include <memory>
+
+#include "aoframecontainer.hpp"
+
+class AOFrameDecodeTask;
+
+struct AOFrameSet
+{
+  QString key;
+  QString path;
+
+  //guards frames, delays, opaque, bytes and finished, the decoder fills them in while we play
+  QMutex mutex;
+
+  //what the decoder produced, handed over to pixmaps by AOFrameCache::prepare_pixmaps
+  QVector<QImage> frames;
+  //how long each frame stays up, in milliseconds
+  QVector<int> delays;
+  //the part of each frame that isn't transparent, the viewport only repaints that
+  QVector<QRect> opaque;
+  qint64 bytes = 0;
+  bool finished = false;
+
+  //ready to blit, only ever touched on the GUI thread
+  QVector<QPixmap> pixmaps;
+
+  //how many players are showing this right now, the decode is cancelled when it drops to 0
+  QAtomicInt players;
+  QAtomicInt cancelled;
+
+  int frame_count();
+  int get_delay(int n_frame);
+  QRect get_opaque(int n_frame);
+  bool is_finished();
+};
+
+typedef std::shared_ptr<AOFrameSet> frame_set_ptr;
+
+/**
+ * @brief The AOFrameCache keeps decoded animations around between plays.
+ * Frames are decoded once per (path, flip, size), already scaled and mirrored, and shared
+ * by everyone who plays the same file. Decoding happens on a thread pool and frames are
+ * published as soon as each one is done, so playback can start on the first frame. The
+ * least recently used animations are dropped once the decoded data goes over the byte budget.
+ * Animations compiled by tools/aoc are read out of their container instead of being decoded.
+ */
+
+class AOFrameCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOFrameCache(QObject *p_parent = nullptr);
+  ~AOFrameCache();
+
+  //Returns the frames of p_path scaled to p_size and mirrored if p_flipped.
+  //On a miss the set comes back empty and fills up in the background
+  frame_set_ptr get_frames(QString p_path, bool p_flipped, QSize p_size);
+
+  //Players hold on to the sets they show. Once nobody shows a set that is still being
+  //decoded, the decode is cancelled, a newer message has taken its place
+  void acquire(const frame_set_ptr &p_frames);
+  void release(const frame_set_ptr &p_frames);
+
+  void clear();
+
+  int get_hits() {return m_hits;}
+  int get_misses() {return m_misses;}
+  //how many of the misses were served out of an animation container
+  int get_container_decodes() {return m_container_decodes.load();}
+  qint64 get_bytes();
+
+  //Turns the frames decoded so far into pixmaps. Must be called on the GUI thread
+  static void prepare_pixmaps(const frame_set_ptr &p_frames);
+
+  //how much decoded image data we keep around
+  static const int byte_budget = 128 * 1024 * 1024;
+
+public slots:
+  //drops the animations and containers under the paths the asset index reported
+  void on_index_changed(QStringList p_changed);
+
+signals:
+  //emitted on the GUI thread whenever the set with p_key got new frames or finished
+  void frames_decoded(QString p_key);
+
+private:
+  QMutex m_mutex;
+
+  QCache<QString, frame_set_ptr> m_cache;
+
+  int m_hits = 0;
+  int m_misses = 0;
+
+  QThreadPool m_pool;
+  QAtomicInt m_abort;
+
+  //containers by path, nullptr for folders that don't have one
+  QMutex m_container_mutex;
+  QHash<QString, std::shared_ptr<AOFrameContainer>> m_containers;
+  QAtomicInt m_container_decodes;
+
+  static QString get_key(QString p_path, bool p_flipped, QSize p_size);
+  std::shared_ptr<AOFrameContainer> get_container(QString p_path);
+
+  void decode(frame_set_ptr p_frames, QString p_path, bool p_flipped, QSize p_size);
+  bool decode_container(frame_set_ptr p_frames, QString p_path, bool p_flipped, QSize p_size);
+  void add_frame(const frame_set_ptr &p_frames, QImage p_image, int p_delay, bool p_flipped, QSize p_size);
+
+  friend class AOFrameDecodeTask;
+};
+
+#endif // AOFRAMECACHE_HPP
@@ -0,0 +1,149 @@
+#include "aoframeclock.hpp"
+
+#include <QPointer>
+#include <QVector>
+
+AOFrameClock::AOFrameClock(QObject *p_parent) : QObject(p_parent)
+{
+  m_clock.start();
+
+  m_timer = new QTimer(this);
+  m_timer->setSingleShot(true);
+  m_timer->setTimerType(Qt::PreciseTimer);
+
+  connect(m_timer, SIGNAL(timeout()), this, SLOT(tick()));
+}
+
+void AOFrameClock::schedule(AOClockTimer *p_timer, qint64 p_deadline)
+{
+  m_queue.insert(p_deadline, p_timer);
+
+  //only matters if it's now the earliest one
+  if (m_queue.constBegin().value() == p_timer)
+    rearm();
+}
+
+void AOFrameClock::cancel(AOClockTimer *p_timer, qint64 p_deadline)
+{
+  bool was_first = !m_queue.isEmpty() && m_queue.constBegin().key() == p_deadline &&
+                   m_queue.constBegin().value() == p_timer;
+
+  m_queue.remove(p_deadline, p_timer);
+
+  //otherwise we'd wake up for a deadline nobody is waiting on anymore
+  if (was_first)
+    rearm();
+}
+
+void AOFrameClock::rearm()
+{
+  if (m_queue.isEmpty())
+  {
+    m_timer->stop();
+    return;
+  }
+
+  qint64 f_wait = m_queue.constBegin().key() - now();
+  m_timer->start(static_cast<int>(qMax(f_wait, qint64(0))));
+}
+
+void AOFrameClock::tick()
+{
+  ++m_wakeups;
+
+  //whatever is due by now, and not a millisecond early, the 10 ms frame delays depend on it
+  qint64 f_limit = now();
+
+  struct due_timer
+  {
+    QPointer<AOClockTimer> timer;
+    qint64 deadline;
+  };
+
+  //taken out first, a timeout is free to start, stop or delete any timer including itself
+  QVector<due_timer> f_due;
+
+  while (!m_queue.isEmpty() && m_queue.constBegin().key() <= f_limit)
+  {
+    due_timer f_timer;
+    f_timer.deadline = m_queue.constBegin().key();
+    f_timer.timer = m_queue.constBegin().value();
+    f_due.append(f_timer);
+
+    m_queue.erase(m_queue.begin());
+  }
+
+  for (const due_timer &f_timer : f_due)
+  {
+    //stopped or restarted by something that fired before it
+    if (f_timer.timer.isNull() || !f_timer.timer->m_active || f_timer.timer->m_deadline != f_timer.deadline)
+      continue;
+
+    //restarted onto the very same deadline, this timeout counts for that one too
+    m_queue.remove(f_timer.deadline, f_timer.timer.data());
+
+    ++m_fired;
+    f_timer.timer->fire();
+  }
+
+  rearm();
+}
+
+AOClockTimer::AOClockTimer(AOFrameClock *p_clock, QObject *p_parent) : QObject(p_parent)
+{
+  m_clock = p_clock;
+}
+
+AOClockTimer::~AOClockTimer()
+{
+  stop();
+}
+
+int AOClockTimer::remainingTime()
+{
+  if (!m_active)
+    return -1;
+
+  return static_cast<int>(qMax(m_deadline - m_clock->now(), qint64(0)));
+}
+
+void AOClockTimer::start()
+{
+  stop();
+
+  m_active = true;
+  m_deadline = m_clock->now() + m_interval;
+  m_clock->schedule(this, m_deadline);
+}
+
+void AOClockTimer::start(int p_interval)
+{
+  m_interval = p_interval;
+  start();
+}
+
+void AOClockTimer::stop()
+{
+  if (!m_active)
+    return;
+
+  m_active = false;
+  m_clock->cancel(this, m_deadline);
+}
+
+void AOClockTimer::fire()
+{
+  if (single_shot)
+    m_active = false;
+  else
+  {
+    //counted from the last deadline so a repeating timer doesn't drift, unless we fell way behind
+    m_deadline += qMax(m_interval, 1);
+    if (m_deadline < m_clock->now())
+      m_deadline = m_clock->now() + m_interval;
+
+    m_clock->schedule(this, m_deadline);
+  }
+
+  emit timeout();
+}
@@ -0,0 +1,97 @@
+#ifndef AOFRAMECLOCK_HPP
+#define AOFRAMECLOCK_HPP
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QMultiMap>
+
+class AOClockTimer;
+
+/**
+ * @brief The AOFrameClock is the one timer every animation in the courtroom runs on.
+ * Instead of each layer and the text reveal arming their own QTimer, they hand their next
+ * deadline to the clock, which wakes up once for the earliest one and fires everything that
+ * is due by then in the same pass. Nothing fires early. Fewer wakeups, and things that are
+ * due together always advance together and in the same order.
+ */
+
+class AOFrameClock : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOFrameClock(QObject *p_parent = nullptr);
+
+  //Milliseconds since the clock was created, deadlines are measured on this
+  qint64 now() {return m_clock.elapsed();}
+
+  //Returns how many times the clock woke up and how many deadlines it fired
+  int get_wakeups() {return m_wakeups;}
+  int get_fired() {return m_fired;}
+
+private:
+  QElapsedTimer m_clock;
+  QTimer *m_timer;
+
+  //deadline -> timer, the earliest one is always up front
+  QMultiMap<qint64, AOClockTimer*> m_queue;
+
+  int m_wakeups = 0;
+  int m_fired = 0;
+
+  void schedule(AOClockTimer *p_timer, qint64 p_deadline);
+  void cancel(AOClockTimer *p_timer, qint64 p_deadline);
+  void rearm();
+
+  friend class AOClockTimer;
+
+private slots:
+  void tick();
+};
+
+/**
+ * @brief The AOClockTimer works like a QTimer, but its timeouts are scheduled on an AOFrameClock.
+ */
+
+class AOClockTimer : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOClockTimer(AOFrameClock *p_clock, QObject *p_parent = nullptr);
+  ~AOClockTimer();
+
+  void setSingleShot(bool p_single_shot) {single_shot = p_single_shot;}
+  bool isSingleShot() {return single_shot;}
+
+  void setInterval(int p_interval) {m_interval = p_interval;}
+  int interval() {return m_interval;}
+
+  bool isActive() {return m_active;}
+
+  //Returns the milliseconds left until the next timeout, or -1 if the timer isn't running
+  int remainingTime();
+
+  void start();
+  void start(int p_interval);
+  void stop();
+
+signals:
+  void timeout();
+
+private:
+  AOFrameClock *m_clock;
+
+  int m_interval = 0;
+  bool single_shot = false;
+
+  bool m_active = false;
+  qint64 m_deadline = 0;
+
+  void fire();
+
+  friend class AOFrameClock;
+};
+
+#endif // AOFRAMECLOCK_HPP
@@ -0,0 +1,237 @@
+#include "aoframecontainer.hpp"
+
+#include "aolz4.hpp"
+
+#include <QFileInfo>
+#include <QDateTime>
+#include <QVector>
+#include <QtEndian>
+#include <QDebug>
+
+#include <cstring>
+
+AOFrameContainer::AOFrameContainer()
+{
+
+}
+
+AOFrameContainer::~AOFrameContainer()
+{
+  close();
+}
+
+QString AOFrameContainer::get_container_path(QString p_source)
+{
+  return p_source.left(p_source.lastIndexOf("/") + 1) + "animations.aoc";
+}
+
+bool AOFrameContainer::open(QString p_file)
+{
+  close();
+
+  m_file.setFileName(p_file);
+
+  if (!m_file.open(QIODevice::ReadOnly))
+    return false;
+
+  m_size = m_file.size();
+  m_data = m_size >= header_size ? m_file.map(0, m_size) : nullptr;
+
+  if (!read_index(p_file))
+  {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+bool AOFrameContainer::open_data(QByteArray p_data)
+{
+  close();
+
+  m_bytes = p_data;
+  m_size = m_bytes.size();
+  m_data = m_size >= header_size ? reinterpret_cast<const uchar*>(m_bytes.constData()) : nullptr;
+
+  if (!read_index("packed container"))
+  {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+void AOFrameContainer::close()
+{
+  if (m_data != nullptr && m_file.isOpen())
+    m_file.unmap(const_cast<uchar*>(m_data));
+
+  m_file.close();
+  m_bytes.clear();
+
+  m_data = nullptr;
+  m_size = 0;
+  m_animation_count = 0;
+  m_animations = nullptr;
+  m_index.clear();
+}
+
+bool AOFrameContainer::read_index(QString p_name)
+{
+  if (m_data == nullptr || memcmp(m_data, "AOFC", 4) != 0 ||
+      qFromLittleEndian<quint32>(m_data + 4) != container_version)
+  {
+    qDebug() << "W:" << p_name << "is not a usable frame container";
+    return false;
+  }
+
+  m_animation_count = qFromLittleEndian<quint32>(m_data + 8);
+  quint64 f_animations_offset = qFromLittleEndian<quint64>(m_data + 16);
+  quint64 f_names_offset = qFromLittleEndian<quint64>(m_data + 24);
+  quint64 f_size = quint64(m_size);
+
+  bool f_valid = f_animations_offset + quint64(m_animation_count) * animation_size <= f_size &&
+      f_names_offset <= f_size;
+
+  //everything read_frame relies on is checked once here
+  for (quint32 n_animation = 0 ; f_valid && n_animation < m_animation_count ; ++n_animation)
+  {
+    const uchar *f_record = m_data + f_animations_offset + n_animation * animation_size;
+
+    quint32 f_name_offset = qFromLittleEndian<quint32>(f_record);
+    quint32 f_name_size = qFromLittleEndian<quint32>(f_record + 4);
+    quint32 f_width = qFromLittleEndian<quint32>(f_record + 8);
+    quint32 f_height = qFromLittleEndian<quint32>(f_record + 12);
+    quint32 f_frame_count = qFromLittleEndian<quint32>(f_record + 16);
+    quint32 f_flags = qFromLittleEndian<quint32>(f_record + 20);
+    quint64 f_frames_offset = qFromLittleEndian<quint64>(f_record + 24);
+    quint64 f_palette_offset = qFromLittleEndian<quint64>(f_record + 32);
+    quint32 f_palette_size = qFromLittleEndian<quint32>(f_record + 40);
+
+    quint64 f_raw_size = quint64(f_width) * f_height * ((f_flags & INDEXED) ? 1 : 4);
+
+    f_valid = f_names_offset + f_name_offset + f_name_size <= f_size &&
+        f_width > 0 && f_height > 0 && f_width <= 16384 && f_height <= 16384 &&
+        f_frames_offset + quint64(f_frame_count) * frame_size <= f_size &&
+        (!(f_flags & INDEXED) || (f_palette_size <= 256 && f_palette_offset + f_palette_size * 4 <= f_size));
+
+    for (quint32 n_frame = 0 ; f_valid && n_frame < f_frame_count ; ++n_frame)
+    {
+      const uchar *f_frame = m_data + f_frames_offset + n_frame * frame_size;
+      quint32 f_stored_size = qFromLittleEndian<quint32>(f_frame + 4);
+      quint64 f_data_offset = qFromLittleEndian<quint64>(f_frame + 8);
+
+      f_valid = f_data_offset + f_stored_size <= f_size &&
+          ((f_flags & LZ4) || f_stored_size == f_raw_size);
+    }
+
+    if (!f_valid)
+      break;
+
+    QString f_name = QString::fromUtf8(reinterpret_cast<const char*>(m_data + f_names_offset + f_name_offset),
+                                       static_cast<int>(f_name_size));
+    m_index.insert(f_name, static_cast<int>(n_animation));
+  }
+
+  if (!f_valid)
+  {
+    qDebug() << "W:" << p_name << "has a broken index";
+    return false;
+  }
+
+  m_animations = m_data + f_animations_offset;
+
+  return true;
+}
+
+int AOFrameContainer::find(QString p_name)
+{
+  return m_index.value(p_name.toLower(), -1);
+}
+
+bool AOFrameContainer::is_current(int p_animation, QString p_source)
+{
+  QFileInfo f_info(p_source);
+
+  //only packed, there's nothing to compare with
+  if (!f_info.exists())
+    return true;
+
+  const uchar *f_record = m_animations + p_animation * animation_size;
+  quint64 f_source_size = qFromLittleEndian<quint64>(f_record + 48);
+  qint64 f_source_time = static_cast<qint64>(qFromLittleEndian<quint64>(f_record + 56));
+
+  return quint64(f_info.size()) == f_source_size && f_info.lastModified().toMSecsSinceEpoch() == f_source_time;
+}
+
+QSize AOFrameContainer::get_size(int p_animation)
+{
+  const uchar *f_record = m_animations + p_animation * animation_size;
+  return QSize(qFromLittleEndian<quint32>(f_record + 8), qFromLittleEndian<quint32>(f_record + 12));
+}
+
+int AOFrameContainer::get_frame_count(int p_animation)
+{
+  return static_cast<int>(qFromLittleEndian<quint32>(m_animations + p_animation * animation_size + 16));
+}
+
+int AOFrameContainer::get_delay(int p_animation, int n_frame)
+{
+  quint64 f_frames_offset = qFromLittleEndian<quint64>(m_animations + p_animation * animation_size + 24);
+  return static_cast<int>(qFromLittleEndian<quint32>(m_data + f_frames_offset + n_frame * frame_size));
+}
+
+QImage AOFrameContainer::read_frame(int p_animation, int n_frame)
+{
+  const uchar *f_record = m_animations + p_animation * animation_size;
+
+  int f_width = static_cast<int>(qFromLittleEndian<quint32>(f_record + 8));
+  int f_height = static_cast<int>(qFromLittleEndian<quint32>(f_record + 12));
+  quint32 f_flags = qFromLittleEndian<quint32>(f_record + 20);
+  quint64 f_frames_offset = qFromLittleEndian<quint64>(f_record + 24);
+
+  const uchar *f_frame = m_data + f_frames_offset + n_frame * frame_size;
+  int f_stored_size = static_cast<int>(qFromLittleEndian<quint32>(f_frame + 4));
+  const uchar *f_pixels = m_data + qFromLittleEndian<quint64>(f_frame + 8);
+
+  int f_pixel_size = (f_flags & INDEXED) ? 1 : 4;
+  int f_row_size = f_width * f_pixel_size;
+
+  QByteArray f_unpacked;
+
+  if (f_flags & LZ4)
+  {
+    f_unpacked.resize(f_row_size * f_height);
+
+    if (!lz4_decompress(reinterpret_cast<const char*>(f_pixels), f_stored_size, f_unpacked.data(), f_unpacked.size()))
+      return QImage();
+
+    f_pixels = reinterpret_cast<const uchar*>(f_unpacked.constData());
+  }
+
+  QImage f_image(f_width, f_height, (f_flags & INDEXED) ? QImage::Format_Indexed8 : QImage::Format_ARGB32_Premultiplied);
+
+  //scanlines may be padded, so it goes row by row
+  for (int n_row = 0 ; n_row < f_height ; ++n_row)
+    memcpy(f_image.scanLine(n_row), f_pixels + n_row * f_row_size, f_row_size);
+
+  if (!(f_flags & INDEXED))
+    return f_image;
+
+  quint64 f_palette_offset = qFromLittleEndian<quint64>(f_record + 32);
+  int f_palette_size = static_cast<int>(qFromLittleEndian<quint32>(f_record + 40));
+
+  QVector<QRgb> f_colors(f_palette_size);
+  for (int n_color = 0 ; n_color < f_palette_size ; ++n_color)
+    f_colors[n_color] = qFromLittleEndian<quint32>(m_data + f_palette_offset + n_color * 4);
+
+  //an index past the end of the palette reads as transparent
+  while (f_colors.size() < 256)
+    f_colors.append(0);
+
+  f_image.setColorTable(f_colors);
+
+  return f_image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
@@ -0,0 +1,86 @@
+#ifndef AOFRAMECONTAINER_HPP
+#define AOFRAMECONTAINER_HPP
+
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QSize>
+
+/**
+ * @brief The AOFrameContainer reads the pre-decoded animations tools/aoc compiles for a character.
+ * Every frame is stored as the pixels we would get out of the GIF/APNG decoder, either as they
+ * are, as palette indices, or LZ4-compressed, together with the delay of each frame. The file
+ * is memory-mapped, so getting a frame out of it costs a copy and at most an LZ4 decompression.
+ *
+ * Layout, all integers little-endian:
+ *   header      magic "AOFC", version, animation count, reserved,
+ *               offsets of the animation table and the names
+ *   data        the pixels of every frame, 4-byte aligned, and the palettes
+ *   frames      per animation, delay, stored size, data offset, reserved
+ *   animations  name offset, name size, width, height, frame count, flags,
+ *               frame table offset, palette offset, palette size, reserved,
+ *               size and modification time of the source file
+ *   names       the lowercase file names of the sources, UTF-8
+ */
+
+class AOFrameContainer
+{
+public:
+  AOFrameContainer();
+  ~AOFrameContainer();
+
+  //Maps p_file into memory. Returns false if it's missing or malformed
+  bool open(QString p_file);
+  //Same, for a container that is already in memory (out of the asset pack)
+  bool open_data(QByteArray p_data);
+  void close();
+  bool is_open() {return m_data != nullptr;}
+
+  //Returns the animation compiled from the file named p_name, or -1
+  int find(QString p_name);
+
+  //Returns false if p_source was changed after the animation was compiled from it
+  bool is_current(int p_animation, QString p_source);
+
+  QSize get_size(int p_animation);
+  int get_frame_count(int p_animation);
+  int get_delay(int p_animation, int n_frame);
+
+  //Returns frame n_frame as premultiplied ARGB32, or a null image if the data is broken
+  QImage read_frame(int p_animation, int n_frame);
+
+  //Returns where the container for the animation at p_source would be
+  static QString get_container_path(QString p_source);
+
+  static const quint32 container_version = 1;
+  static const int header_size = 32;
+  static const int animation_size = 64;
+  static const int frame_size = 24;
+
+  enum animation_flag
+  {
+    //one byte per pixel indexing into a palette of up to 256 non-premultiplied ARGB colors
+    INDEXED = 1,
+    //every frame is a separate LZ4 block
+    LZ4 = 2
+  };
+
+private:
+  QFile m_file;
+  QByteArray m_bytes;
+
+  const uchar *m_data = nullptr;
+  qint64 m_size = 0;
+
+  quint32 m_animation_count = 0;
+  const uchar *m_animations = nullptr;
+
+  //lowercase file name -> animation index
+  QHash<QString, int> m_index;
+
+  bool read_index(QString p_name);
+};
+
+#endif // AOFRAMECONTAINER_HPP
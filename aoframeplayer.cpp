@@ -0,0 +1,164 @@
+#include "aoframeplayer.hpp"
+
+#include "aoapplication.h"
+#include "aoviewport.hpp"
+
+AOFramePlayer::AOFramePlayer(QLabel *p_target, AOApplication *p_ao_app) : QObject(p_target)
+{
+  m_target = p_target;
+  ao_app = p_ao_app;
+
+  frame_timer = new AOClockTimer(ao_app->frame_clock, this);
+  frame_timer->setSingleShot(true);
+
+  hold_timer = new AOClockTimer(ao_app->frame_clock, this);
+  hold_timer->setSingleShot(true);
+
+  connect(frame_timer, SIGNAL(timeout()), this, SLOT(next_frame()));
+  //a deadline like any other, whoever listens gets called straight from the event loop
+  connect(hold_timer, SIGNAL(timeout()), this, SIGNAL(finished()));
+  connect(ao_app->frame_cache, SIGNAL(frames_decoded(QString)), this, SLOT(on_frames_decoded(QString)));
+}
+
+AOFramePlayer::~AOFramePlayer()
+{
+  set_frames(nullptr);
+}
+
+void AOFramePlayer::play(QString p_path, QSize p_size, bool p_flipped)
+{
+  play_frames(ao_app->frame_cache->get_frames(p_path, p_flipped, p_size), p_path, p_size, p_flipped);
+}
+
+void AOFramePlayer::play_frames(frame_set_ptr p_frames, QString p_path, QSize p_size, bool p_flipped)
+{
+  frame_timer->stop();
+  hold_timer->stop();
+
+  m_path = p_path;
+  m_size = p_size;
+  m_flipped = p_flipped;
+
+  set_frames(p_frames);
+
+  show_frame(0);
+}
+
+void AOFramePlayer::stop()
+{
+  frame_timer->stop();
+  hold_timer->stop();
+
+  //lets a decode that nobody needs anymore stop early
+  set_frames(nullptr);
+}
+
+void AOFramePlayer::set_size(QSize p_size)
+{
+  m_size = p_size;
+
+  //the cached frames are scaled to the old size
+  if (!m_frames)
+    return;
+
+  bool was_waiting = m_waiting;
+
+  set_frames(ao_app->frame_cache->get_frames(m_path, m_flipped, m_size));
+
+  //the new set may already have the frame we were waiting for, otherwise we wait on it instead
+  if (was_waiting)
+  {
+    show_frame(m_frame);
+    return;
+  }
+
+  AOFrameCache::prepare_pixmaps(m_frames);
+
+  if (m_frame < m_frames->pixmaps.size())
+    AOViewport::set_pixmap(m_target, m_frames->pixmaps.at(m_frame), m_frames->get_opaque(m_frame));
+}
+
+void AOFramePlayer::set_frames(frame_set_ptr p_frames)
+{
+  if (p_frames)
+    ao_app->frame_cache->acquire(p_frames);
+  if (m_frames)
+    ao_app->frame_cache->release(m_frames);
+
+  m_frames = p_frames;
+  m_waiting = false;
+}
+
+void AOFramePlayer::show_frame(int n_frame)
+{
+  if (!m_frames)
+    return;
+
+  //checked before taking the frames, so a frame that shows up in between still gets drawn next time
+  bool finished = m_frames->is_finished();
+
+  AOFrameCache::prepare_pixmaps(m_frames);
+  int frame_count = m_frames->pixmaps.size();
+
+  if (n_frame >= frame_count)
+  {
+    if (!finished)
+    {
+      //picked up again in on_frames_decoded
+      m_frame = n_frame;
+      m_waiting = true;
+      return;
+    }
+
+    if (frame_count == 0)
+    {
+      AOViewport::clear_pixmap(m_target);
+      return;
+    }
+
+    //the frame before was the last one, but we only know that now
+    if (play_once)
+    {
+      hold_timer->start(0);
+      return;
+    }
+
+    n_frame = 0;
+  }
+
+  m_frame = n_frame;
+  m_waiting = false;
+
+  //already scaled and converted, this only swaps the pixmap and repaints what of it isn't transparent
+  AOViewport::set_pixmap(m_target, m_frames->pixmaps.at(n_frame), m_frames->get_opaque(n_frame));
+
+  emit frame_changed(n_frame);
+
+  int f_delay = m_frames->get_delay(n_frame);
+  if (m_speed > 0 && m_speed != 100)
+    f_delay = f_delay * 100 / m_speed;
+
+  if (finished && n_frame == frame_count - 1 && play_once)
+  {
+    hold_timer->start(f_delay);
+    return;
+  }
+
+  //a still image
+  if (finished && frame_count == 1)
+    return;
+
+  //gifs with no delay at all would just spin
+  frame_timer->start(qMax(f_delay, 10));
+}
+
+void AOFramePlayer::next_frame()
+{
+  show_frame(m_frame + 1);
+}
+
+void AOFramePlayer::on_frames_decoded(QString p_key)
+{
+  if (m_waiting && m_frames && m_frames->key == p_key)
+    show_frame(m_frame);
+}
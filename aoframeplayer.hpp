@@ -0,0 +1,77 @@
+#ifndef AOFRAMEPLAYER_HPP
+#define AOFRAMEPLAYER_HPP
+
+#include <QObject>
+#include <QLabel>
+#include <QSize>
+
+#include "aoframecache.hpp"
+#include "aoframeclock.hpp"
+
+class AOApplication;
+
+/**
+ * @brief The AOFramePlayer plays an animation out of the frame cache onto a label.
+ * Frames are advanced by the application's frame clock, so every layer that plays
+ * something wakes up on the same ticks. Still images are just one frame that never advances.
+ */
+
+class AOFramePlayer : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOFramePlayer(QLabel *p_target, AOApplication *p_ao_app);
+  ~AOFramePlayer();
+
+  //Starts p_path from the first frame, scaled to p_size (or as it is if p_size is invalid)
+  void play(QString p_path, QSize p_size, bool p_flipped = false);
+  //Same, for frames of p_path someone already got out of the frame cache
+  void play_frames(frame_set_ptr p_frames, QString p_path, QSize p_size, bool p_flipped = false);
+  void stop();
+
+  //Keeps the current frame but switches to frames scaled to p_size
+  void set_size(QSize p_size);
+
+  //playback speed in percent
+  void set_speed(int p_speed) {m_speed = p_speed;}
+  void set_play_once(bool p_play_once) {play_once = p_play_once;}
+
+  bool is_playing() {return m_frames != nullptr;}
+  frame_set_ptr get_frames() {return m_frames;}
+  QString get_path() {return m_path;}
+
+signals:
+  void frame_changed(int n_frame);
+
+  //play_once only, the last frame has been up for as long as it wanted to be
+  void finished();
+
+private:
+  QLabel *m_target;
+  AOApplication *ao_app = nullptr;
+
+  frame_set_ptr m_frames;
+  QString m_path;
+  QSize m_size;
+  bool m_flipped = false;
+  int m_frame = 0;
+  //the frame we want to show next is still being decoded
+  bool m_waiting = false;
+
+  int m_speed = 100;
+  bool play_once = false;
+
+  AOClockTimer *frame_timer;
+  //holds the last frame of a play_once animation before we say we're done
+  AOClockTimer *hold_timer;
+
+  void set_frames(frame_set_ptr p_frames);
+  void show_frame(int n_frame);
+
+private slots:
+  void next_frame();
+  void on_frames_decoded(QString p_key);
+};
+
+#endif // AOFRAMEPLAYER_HPP
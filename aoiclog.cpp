@@ -0,0 +1,476 @@
+#include "aoiclog.hpp"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QTextOption>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QMenu>
+#include <QApplication>
+#include <QClipboard>
+#include <QtMath>
+
+AOICLog::AOICLog(QWidget *p_parent) : QAbstractScrollArea(p_parent)
+{
+  setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+  setFocusPolicy(Qt::ClickFocus);
+
+  //plenty for a screenful of rows, anything scrolled away is laid out again if it comes back
+  m_layouts.setMaxCost(256);
+
+  verticalScrollBar()->setSingleStep(1);
+  set_capacity(200);
+}
+
+void AOICLog::append(QString p_name, QString p_line)
+{
+  if (m_records.isEmpty())
+    return;
+
+  bool f_follow = is_following();
+  bool f_evicted = false;
+
+  if (m_count == m_records.size())
+  {
+    //full, the oldest record makes room
+    m_records[m_first] = record_type();
+    m_first = (m_first + 1) % m_records.size();
+    --m_count;
+    f_evicted = true;
+  }
+
+  record_type &f_record = m_records[(m_first + m_count) % m_records.size()];
+  f_record.name = p_name;
+  f_record.line = p_line;
+  ++m_count;
+  ++m_next_serial;
+
+  QScrollBar *f_bar = verticalScrollBar();
+  int f_value = f_bar->value();
+
+  update_scrollbar(f_follow);
+
+  //keep the rows the user is reading where they are
+  if (!f_follow)
+  {
+    if (newest_on_top)
+      f_bar->setValue(f_value + 1);
+    else if (f_evicted)
+      f_bar->setValue(f_value - 1);
+  }
+
+  viewport()->update();
+}
+
+void AOICLog::clear()
+{
+  for (record_type &f_record : m_records)
+    f_record = record_type();
+
+  m_first = 0;
+  m_count = 0;
+  m_layouts.clear();
+  clear_selection();
+
+  update_scrollbar(true);
+  viewport()->update();
+}
+
+void AOICLog::set_capacity(int p_capacity)
+{
+  p_capacity = qMax(1, p_capacity);
+
+  if (p_capacity == m_records.size())
+    return;
+
+  QVector<record_type> f_records(p_capacity);
+  int f_count = qMin(m_count, p_capacity);
+
+  //the newest ones make it, in order
+  for (int n_record = 0 ; n_record < f_count ; ++n_record)
+    f_records[n_record] = m_records[(m_first + m_count - f_count + n_record) % m_records.size()];
+
+  m_records = f_records;
+  m_first = 0;
+  m_count = f_count;
+
+  update_scrollbar(true);
+  viewport()->update();
+}
+
+void AOICLog::set_newest_on_top(bool p_newest_on_top)
+{
+  if (p_newest_on_top == newest_on_top)
+    return;
+
+  newest_on_top = p_newest_on_top;
+
+  update_scrollbar(true);
+  viewport()->update();
+}
+
+int AOICLog::get_index(int n_row)
+{
+  int f_offset = newest_on_top ? m_count - 1 - n_row : n_row;
+  return (m_first + f_offset) % m_records.size();
+}
+
+quint64 AOICLog::get_serial(int n_row)
+{
+  int f_offset = newest_on_top ? m_count - 1 - n_row : n_row;
+  return m_next_serial - m_count + f_offset;
+}
+
+QTextLayout *AOICLog::get_layout(int n_row)
+{
+  quint64 f_serial = get_serial(n_row);
+
+  QTextLayout *f_layout = m_layouts.object(f_serial);
+  if (f_layout)
+    return f_layout;
+
+  const record_type &f_record = m_records.at(get_index(n_row));
+
+  f_layout = new QTextLayout(f_record.name + f_record.line, font());
+
+  QTextLayout::FormatRange f_bold;
+  f_bold.start = 0;
+  f_bold.length = f_record.name.size();
+  f_bold.format.setFontWeight(QFont::Bold);
+  f_layout->setFormats(QVector<QTextLayout::FormatRange>{f_bold});
+
+  QTextOption f_option;
+  f_option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+  f_layout->setTextOption(f_option);
+
+  qreal f_width = qMax(0, viewport()->width() - 2 * margin);
+  qreal f_y = 0;
+
+  f_layout->beginLayout();
+
+  for (QTextLine f_line = f_layout->createLine() ; f_line.isValid() ; f_line = f_layout->createLine())
+  {
+    f_line.setLineWidth(f_width);
+    f_line.setPosition(QPointF(0, f_y));
+    f_y += f_line.height();
+  }
+
+  f_layout->endLayout();
+
+  m_layouts.insert(f_serial, f_layout);
+  return f_layout;
+}
+
+int AOICLog::get_row_height(int n_row)
+{
+  return qMax(1, qCeil(get_layout(n_row)->boundingRect().height()));
+}
+
+int AOICLog::get_row_at(QPoint p_pos, int &p_top)
+{
+  int f_y = margin;
+
+  for (int n_row = verticalScrollBar()->value() ; n_row < m_count ; ++n_row)
+  {
+    if (f_y > viewport()->height())
+      break;
+
+    p_top = f_y;
+    f_y += get_row_height(n_row);
+
+    if (p_pos.y() < f_y)
+      return n_row;
+  }
+
+  return -1;
+}
+
+bool AOICLog::get_position_at(QPoint p_pos, text_position &p_position)
+{
+  int f_top = margin;
+  int f_row = get_row_at(p_pos, f_top);
+  bool is_past_end = false;
+
+  //below the last row on screen, the end of that row
+  if (f_row < 0)
+  {
+    int f_y = margin;
+
+    for (int n_row = verticalScrollBar()->value() ; n_row < m_count && f_y <= viewport()->height() ; ++n_row)
+    {
+      f_top = f_y;
+      f_y += get_row_height(n_row);
+      f_row = n_row;
+    }
+
+    if (f_row < 0)
+      return false;
+
+    is_past_end = true;
+  }
+
+  QTextLayout *f_layout = get_layout(f_row);
+  p_position.serial = get_serial(f_row);
+
+  if (is_past_end || f_layout->lineCount() == 0)
+  {
+    p_position.pos = is_past_end ? f_layout->text().size() : 0;
+    return true;
+  }
+
+  //the line under the pointer, the first or last one if it's above or below all of them
+  qreal f_y = p_pos.y() - f_top;
+  QTextLine f_line = f_layout->lineAt(f_layout->lineCount() - 1);
+
+  for (int n_line = 0 ; n_line < f_layout->lineCount() ; ++n_line)
+  {
+    if (f_y < f_layout->lineAt(n_line).rect().bottom())
+    {
+      f_line = f_layout->lineAt(n_line);
+      break;
+    }
+  }
+
+  p_position.pos = f_line.xToCursor(p_pos.x() - margin);
+  return true;
+}
+
+bool AOICLog::is_following()
+{
+  QScrollBar *f_bar = verticalScrollBar();
+
+  if (newest_on_top)
+    return f_bar->value() == f_bar->minimum();
+
+  return f_bar->value() == f_bar->maximum();
+}
+
+void AOICLog::update_scrollbar(bool p_follow)
+{
+  //the last row that can be at the top is the one that gets the bottom rows on screen,
+  //only the rows that fit are measured
+  int f_space = viewport()->height() - 2 * margin;
+  int f_fitting = 0;
+
+  for (int n_row = m_count - 1 ; n_row >= 0 ; --n_row)
+  {
+    f_space -= get_row_height(n_row);
+    if (f_space < 0)
+      break;
+
+    ++f_fitting;
+  }
+
+  int f_maximum = qMax(0, m_count - qMax(1, f_fitting));
+
+  QScrollBar *f_bar = verticalScrollBar();
+  f_bar->setRange(0, f_maximum);
+  f_bar->setPageStep(qMax(1, f_fitting));
+
+  if (p_follow)
+    f_bar->setValue(newest_on_top ? 0 : f_maximum);
+}
+
+bool AOICLog::has_selection()
+{
+  return m_selection_anchor.serial >= 0 && m_selection_end.serial >= 0 &&
+      (m_selection_anchor.serial != m_selection_end.serial || m_selection_anchor.pos != m_selection_end.pos);
+}
+
+void AOICLog::get_selection(text_position &p_start, text_position &p_end)
+{
+  bool is_backwards = m_selection_end.serial < m_selection_anchor.serial ||
+      (m_selection_end.serial == m_selection_anchor.serial && m_selection_end.pos < m_selection_anchor.pos);
+
+  p_start = is_backwards ? m_selection_end : m_selection_anchor;
+  p_end = is_backwards ? m_selection_anchor : m_selection_end;
+}
+
+void AOICLog::clear_selection()
+{
+  m_selection_anchor = text_position();
+  m_selection_end = text_position();
+}
+
+void AOICLog::copy_selection()
+{
+  if (!has_selection())
+    return;
+
+  text_position f_start;
+  text_position f_end;
+  get_selection(f_start, f_end);
+
+  qint64 f_oldest = static_cast<qint64>(m_next_serial) - m_count;
+
+  //the start of the selection scrolled out of the log already
+  if (f_start.serial < f_oldest)
+  {
+    f_start.serial = f_oldest;
+    f_start.pos = 0;
+  }
+
+  QStringList f_lines;
+
+  //serial order is chronological no matter which way the log is shown
+  for (qint64 n_serial = f_start.serial ; n_serial <= f_end.serial ; ++n_serial)
+  {
+    const record_type &f_record = m_records.at((m_first + (n_serial - f_oldest)) % m_records.size());
+    QString f_text = f_record.name + f_record.line;
+
+    int f_from = n_serial == f_start.serial ? f_start.pos : 0;
+    int f_to = n_serial == f_end.serial ? f_end.pos : f_text.size();
+
+    f_lines.append(f_text.mid(f_from, f_to - f_from));
+  }
+
+  if (!f_lines.isEmpty())
+    QApplication::clipboard()->setText(f_lines.join("\n"));
+}
+
+void AOICLog::paintEvent(QPaintEvent *event)
+{
+  QPainter f_painter(viewport());
+  f_painter.setPen(palette().color(QPalette::Text));
+
+  int f_y = margin;
+
+  text_position f_start;
+  text_position f_end;
+  bool f_has_selection = has_selection();
+  if (f_has_selection)
+    get_selection(f_start, f_end);
+
+  QTextLayout::FormatRange f_selected;
+  f_selected.format.setBackground(palette().brush(QPalette::Highlight));
+  f_selected.format.setForeground(palette().brush(QPalette::HighlightedText));
+
+  for (int n_row = verticalScrollBar()->value() ; n_row < m_count ; ++n_row)
+  {
+    if (f_y > event->rect().bottom())
+      break;
+
+    QTextLayout *f_layout = get_layout(n_row);
+    int f_height = get_row_height(n_row);
+
+    if (f_y + f_height >= event->rect().top())
+    {
+      qint64 f_serial = static_cast<qint64>(get_serial(n_row));
+      QVector<QTextLayout::FormatRange> f_selections;
+
+      if (f_has_selection && f_serial >= f_start.serial && f_serial <= f_end.serial)
+      {
+        f_selected.start = f_serial == f_start.serial ? f_start.pos : 0;
+        int f_to = f_serial == f_end.serial ? f_end.pos : f_layout->text().size();
+        f_selected.length = f_to - f_selected.start;
+        f_selections.append(f_selected);
+      }
+
+      f_layout->draw(&f_painter, QPointF(margin, f_y), f_selections);
+    }
+
+    f_y += f_height;
+  }
+}
+
+void AOICLog::resizeEvent(QResizeEvent *event)
+{
+  bool f_follow = is_following();
+
+  QAbstractScrollArea::resizeEvent(event);
+
+  //rows wrap differently now
+  m_layouts.clear();
+  update_scrollbar(f_follow);
+}
+
+void AOICLog::changeEvent(QEvent *event)
+{
+  QAbstractScrollArea::changeEvent(event);
+
+  if (event->type() == QEvent::FontChange)
+  {
+    bool f_follow = is_following();
+
+    m_layouts.clear();
+    update_scrollbar(f_follow);
+    viewport()->update();
+  }
+}
+
+void AOICLog::scrollContentsBy(int dx, int dy)
+{
+  Q_UNUSED(dx);
+  Q_UNUSED(dy);
+
+  //rows don't have a fixed height, there is nothing to move over
+  viewport()->update();
+}
+
+void AOICLog::mousePressEvent(QMouseEvent *event)
+{
+  if (event->button() != Qt::LeftButton)
+  {
+    QAbstractScrollArea::mousePressEvent(event);
+    return;
+  }
+
+  text_position f_position;
+
+  if (get_position_at(event->pos(), f_position))
+  {
+    m_selection_anchor = f_position;
+    m_selection_end = f_position;
+  }
+  else
+    clear_selection();
+
+  viewport()->update();
+}
+
+void AOICLog::mouseMoveEvent(QMouseEvent *event)
+{
+  if (!(event->buttons() & Qt::LeftButton) || m_selection_anchor.serial < 0)
+    return;
+
+  text_position f_position;
+  if (!get_position_at(event->pos(), f_position))
+    return;
+
+  m_selection_end = f_position;
+  viewport()->update();
+}
+
+void AOICLog::keyPressEvent(QKeyEvent *event)
+{
+  if (event->matches(QKeySequence::Copy))
+  {
+    copy_selection();
+    return;
+  }
+
+  if (event->matches(QKeySequence::SelectAll) && m_count > 0)
+  {
+    m_selection_anchor.serial = m_next_serial - m_count;
+    m_selection_anchor.pos = 0;
+    m_selection_end.serial = m_next_serial - 1;
+    m_selection_end.pos = get_layout(newest_on_top ? 0 : m_count - 1)->text().size();
+    viewport()->update();
+    return;
+  }
+
+  QAbstractScrollArea::keyPressEvent(event);
+}
+
+void AOICLog::contextMenuEvent(QContextMenuEvent *event)
+{
+  QMenu f_menu(this);
+
+  QAction *f_copy = f_menu.addAction("Copy");
+  f_copy->setEnabled(has_selection());
+
+  if (f_menu.exec(event->globalPos()) == f_copy)
+    copy_selection();
+}
@@ -0,0 +1,94 @@
+#ifndef AOICLOG_HPP
+#define AOICLOG_HPP
+
+#include <QAbstractScrollArea>
+#include <QVector>
+#include <QCache>
+#include <QTextLayout>
+
+#include "datatypes.h"
+
+/**
+ * @brief The AOICLog shows the IC chat history.
+ * Records live in a ring buffer that never grows past the chatlog limit, the oldest one is
+ * overwritten once it's full. Only the rows on screen are laid out and painted, and the
+ * scrollbar counts rows instead of pixels, so appending costs the same with 200 records as
+ * with 100000.
+ */
+
+class AOICLog : public QAbstractScrollArea
+{
+  Q_OBJECT
+
+public:
+  AOICLog(QWidget *p_parent);
+
+  void append(QString p_name, QString p_line);
+  void clear();
+
+  //Keeps the newest p_capacity records, the rest are dropped
+  void set_capacity(int p_capacity);
+  int get_capacity() {return m_records.size();}
+  int get_count() {return m_count;}
+
+  //the "scroll_type" setting, newest record first or last
+  void set_newest_on_top(bool p_newest_on_top);
+
+  //same as the document margin QTextEdit had
+  static const int margin = 4;
+
+protected:
+  void paintEvent(QPaintEvent *event);
+  void resizeEvent(QResizeEvent *event);
+  void changeEvent(QEvent *event);
+  void scrollContentsBy(int dx, int dy);
+
+  void mousePressEvent(QMouseEvent *event);
+  void mouseMoveEvent(QMouseEvent *event);
+  void keyPressEvent(QKeyEvent *event);
+  void contextMenuEvent(QContextMenuEvent *event);
+
+private:
+  //ring buffer, the oldest record is at m_first
+  QVector<record_type> m_records;
+  int m_first = 0;
+  int m_count = 0;
+  //every record gets the next one, so layouts and the selection survive records moving around
+  quint64 m_next_serial = 0;
+
+  bool newest_on_top = false;
+
+  //serial -> the record laid out at the current width
+  QCache<quint64, QTextLayout> m_layouts;
+
+  //a character in a record, by serial so it survives records moving around
+  struct text_position
+  {
+    qint64 serial = -1;
+    int pos = 0;
+  };
+
+  //where the selection was started and where it was dragged to, in either order
+  text_position m_selection_anchor;
+  text_position m_selection_end;
+
+  //n_row counts from the top of the view
+  int get_index(int n_row);
+  quint64 get_serial(int n_row);
+  QTextLayout *get_layout(int n_row);
+  int get_row_height(int n_row);
+  //returns the row under p_pos.y() and sets p_top to where it starts, -1 below the last row
+  int get_row_at(QPoint p_pos, int &p_top);
+  //returns false if there is no row on screen to point at
+  bool get_position_at(QPoint p_pos, text_position &p_position);
+
+  bool is_following();
+  void update_scrollbar(bool p_follow);
+  bool has_selection();
+  //sets p_start and p_end to the ends of the selection, oldest first
+  void get_selection(text_position &p_start, text_position &p_end);
+  void clear_selection();
+  void copy_selection();
+};
+
+#endif // AOICLOG_HPP
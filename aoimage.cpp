@@ -1,6 +1,7 @@
 #include "file_functions.h"
 
 #include "aoimage.h"
+#include "aoviewport.hpp"
 
 #include <QDebug>
 
@@ -16,19 +17,14 @@ AOImage::~AOImage()
 
 void AOImage::set_image(QString p_image)
 {
-  QString theme_image_path = ao_app->get_theme_path() + p_image;
-  QString default_image_path = ao_app->get_default_theme_path() + p_image;
+  QString final_image_path = ao_app->asset_resolver->resolve({"theme"}, p_image);
 
-  QString final_image_path;
+  if (final_image_path == "")
+    final_image_path = ao_app->get_default_theme_path() + p_image;
 
-  if (file_exists(theme_image_path))
-    final_image_path = theme_image_path;
-  else
-    final_image_path = default_image_path;
-
-  QPixmap f_pixmap(final_image_path);
+  QPixmap f_pixmap = load_pixmap(final_image_path);
 
-  this->setPixmap(f_pixmap.scaled(this->width(), this->height(), Qt::IgnoreAspectRatio));
+  AOViewport::set_pixmap(this, f_pixmap.scaled(this->width(), this->height(), Qt::IgnoreAspectRatio));
 }
 
 void AOImage::set_image_from_path(QString p_path)
@@ -42,7 +38,7 @@ void AOImage::set_image_from_path(QString p_path)
   else
     final_path = default_path;
 
-  QPixmap f_pixmap(final_path);
+  QPixmap f_pixmap = load_pixmap(final_path);
 
-  this->setPixmap(f_pixmap.scaled(this->width(), this->height(), Qt::IgnoreAspectRatio));
+  AOViewport::set_pixmap(this, f_pixmap.scaled(this->width(), this->height(), Qt::IgnoreAspectRatio));
 }
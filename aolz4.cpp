@@ -0,0 +1,175 @@
+#include "aolz4.hpp"
+
+#include <QVector>
+
+#include <cstring>
+
+static const int min_match = 4;
+//the format wants the last 5 bytes to be literals and the last match to start 12 bytes before the end
+static const int last_literals = 5;
+static const int match_find_limit = 12;
+static const int max_offset = 65535;
+static const int hash_bits = 16;
+
+static quint32 read_u32(const uchar *p_data)
+{
+  quint32 f_value;
+  memcpy(&f_value, p_data, 4);
+  return f_value;
+}
+
+static int hash_sequence(quint32 p_sequence)
+{
+  return static_cast<int>((p_sequence * 2654435761u) >> (32 - hash_bits));
+}
+
+static void write_length(QByteArray &p_out, int p_length)
+{
+  while (p_length >= 255)
+  {
+    p_out.append(char(255));
+    p_length -= 255;
+  }
+
+  p_out.append(char(p_length));
+}
+
+static void write_sequence(QByteArray &p_out, const uchar *p_literals, int p_literal_count, int p_offset, int p_match_length)
+{
+  int f_match_code = p_match_length - min_match;
+
+  uchar f_token = uchar(qMin(p_literal_count, 15) << 4);
+  if (p_match_length > 0)
+    f_token |= uchar(qMin(f_match_code, 15));
+
+  p_out.append(char(f_token));
+
+  if (p_literal_count >= 15)
+    write_length(p_out, p_literal_count - 15);
+
+  p_out.append(reinterpret_cast<const char*>(p_literals), p_literal_count);
+
+  //the last sequence is literals only
+  if (p_match_length == 0)
+    return;
+
+  p_out.append(char(p_offset & 0xFF));
+  p_out.append(char((p_offset >> 8) & 0xFF));
+
+  if (f_match_code >= 15)
+    write_length(p_out, f_match_code - 15);
+}
+
+QByteArray lz4_compress(const char *p_data, int p_size)
+{
+  const uchar *f_src = reinterpret_cast<const uchar*>(p_data);
+
+  QByteArray f_out;
+  f_out.reserve(p_size + p_size / 255 + 16);
+
+  QVector<int> f_table(1 << hash_bits, -1);
+
+  int f_anchor = 0;
+  int f_pos = 0;
+  int f_start_limit = p_size - match_find_limit;
+  int f_end_limit = p_size - last_literals;
+
+  while (f_pos < f_start_limit)
+  {
+    quint32 f_sequence = read_u32(f_src + f_pos);
+    int f_hash = hash_sequence(f_sequence);
+    int f_ref = f_table.at(f_hash);
+    f_table[f_hash] = f_pos;
+
+    if (f_ref < 0 || f_pos - f_ref > max_offset || read_u32(f_src + f_ref) != f_sequence)
+    {
+      ++f_pos;
+      continue;
+    }
+
+    int f_length = min_match;
+    while (f_pos + f_length < f_end_limit && f_src[f_ref + f_length] == f_src[f_pos + f_length])
+      ++f_length;
+
+    write_sequence(f_out, f_src + f_anchor, f_pos - f_anchor, f_pos - f_ref, f_length);
+
+    f_pos += f_length;
+    f_anchor = f_pos;
+  }
+
+  write_sequence(f_out, f_src + f_anchor, p_size - f_anchor, 0, 0);
+
+  return f_out;
+}
+
+bool lz4_decompress(const char *p_src, int p_src_size, char *p_dst, int p_dst_size)
+{
+  const uchar *f_in = reinterpret_cast<const uchar*>(p_src);
+  const uchar *f_in_end = f_in + p_src_size;
+  uchar *f_out = reinterpret_cast<uchar*>(p_dst);
+  uchar *f_out_start = f_out;
+  uchar *f_out_end = f_out + p_dst_size;
+
+  while (f_in < f_in_end)
+  {
+    uchar f_token = *f_in++;
+
+    int f_literals = f_token >> 4;
+    if (f_literals == 15)
+    {
+      uchar f_byte;
+      do
+      {
+        if (f_in >= f_in_end)
+          return false;
+        f_byte = *f_in++;
+        f_literals += f_byte;
+      } while (f_byte == 255);
+    }
+
+    if (f_literals > f_in_end - f_in || f_literals > f_out_end - f_out)
+      return false;
+
+    memcpy(f_out, f_in, f_literals);
+    f_in += f_literals;
+    f_out += f_literals;
+
+    //the last sequence has no match
+    if (f_in == f_in_end)
+      break;
+
+    if (f_in_end - f_in < 2)
+      return false;
+
+    int f_offset = f_in[0] | (f_in[1] << 8);
+    f_in += 2;
+
+    if (f_offset == 0 || f_offset > f_out - f_out_start)
+      return false;
+
+    int f_length = f_token & 0x0F;
+    if (f_length == 15)
+    {
+      uchar f_byte;
+      do
+      {
+        if (f_in >= f_in_end)
+          return false;
+        f_byte = *f_in++;
+        f_length += f_byte;
+      } while (f_byte == 255);
+    }
+    f_length += min_match;
+
+    if (f_length > f_out_end - f_out)
+      return false;
+
+    //the match may overlap what it is writing, so it has to go byte by byte
+    const uchar *f_match = f_out - f_offset;
+    for (int n_byte = 0 ; n_byte < f_length ; ++n_byte)
+      f_out[n_byte] = f_match[n_byte];
+    f_out += f_length;
+  }
+
+  return f_out == f_out_end;
+}
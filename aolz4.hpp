@@ -0,0 +1,15 @@
+#ifndef AOLZ4_HPP
+#define AOLZ4_HPP
+
+#include <QByteArray>
+
+//A small implementation of the LZ4 block format, enough for the frame containers written by tools/aoc.
+//There's no frame format, checksums or dictionary support, callers have to know the decompressed size.
+
+//Returns p_data compressed as one LZ4 block
+QByteArray lz4_compress(const char *p_data, int p_size);
+
+//Decompresses one LZ4 block into p_dst. Returns false unless it is well-formed and fills exactly p_dst_size bytes
+bool lz4_decompress(const char *p_src, int p_src_size, char *p_dst, int p_dst_size);
+
+#endif // AOLZ4_HPP
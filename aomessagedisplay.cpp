@@ -0,0 +1,161 @@
+#include "aomessagedisplay.hpp"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QTextOption>
+#include <QtMath>
+
+AOMessageDisplay::AOMessageDisplay(QWidget *p_parent) : QWidget(p_parent)
+{
+  setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+void AOMessageDisplay::set_message(QString p_message, QVector<QTextLayout::FormatRange> p_formats)
+{
+  m_message = p_message;
+  m_formats = p_formats;
+  m_visible = 0;
+  m_scroll = 0;
+
+  do_layout();
+  update();
+}
+
+void AOMessageDisplay::clear()
+{
+  set_message("", QVector<QTextLayout::FormatRange>());
+}
+
+void AOMessageDisplay::set_visible_length(int p_length)
+{
+  int f_old_visible = m_visible;
+  m_visible = qBound(0, p_length, m_message.size());
+
+  if (m_visible == f_old_visible)
+    return;
+
+  int f_scroll = get_scroll();
+
+  if (f_scroll != m_scroll)
+  {
+    m_scroll = f_scroll;
+    update();
+    return;
+  }
+
+  //only the lines between the old end and the new one changed, usually that's just the one
+  int f_first = m_layout.lineForTextPosition(qMax(0, qMin(f_old_visible, m_visible) - 1)).lineNumber();
+  int f_last = m_layout.lineForTextPosition(qMax(f_old_visible, m_visible) - 1).lineNumber();
+
+  QRect f_dirty;
+  for (int n_line = qMax(0, f_first) ; n_line <= f_last ; ++n_line)
+    f_dirty |= get_line_rect(n_line);
+
+  update(f_dirty);
+}
+
+void AOMessageDisplay::do_layout()
+{
+  m_layout.clearLayout();
+  m_layout.setText(m_message);
+  m_layout.setFont(font());
+  m_layout.setFormats(m_formats);
+
+  QTextOption f_option;
+  f_option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+  m_layout.setTextOption(f_option);
+
+  qreal f_width = qMax(0, width() - 2 * margin);
+  qreal f_y = 0;
+
+  m_layout.beginLayout();
+
+  for (QTextLine f_line = m_layout.createLine() ; f_line.isValid() ; f_line = m_layout.createLine())
+  {
+    f_line.setLineWidth(f_width);
+    f_line.setPosition(QPointF(0, f_y));
+    f_y += f_line.height();
+  }
+
+  m_layout.endLayout();
+
+  m_scroll = get_scroll();
+}
+
+int AOMessageDisplay::get_scroll()
+{
+  if (m_visible == 0)
+    return 0;
+
+  QTextLine f_line = m_layout.lineForTextPosition(m_visible - 1);
+  if (!f_line.isValid())
+    return 0;
+
+  int f_bottom = qCeil(f_line.y() + f_line.height()) + 2 * margin;
+
+  return qMax(0, f_bottom - height());
+}
+
+QRect AOMessageDisplay::get_line_rect(int n_line)
+{
+  QTextLine f_line = m_layout.lineAt(n_line);
+  if (!f_line.isValid())
+    return QRect();
+
+  return QRectF(0, f_line.y() + margin - m_scroll, width(), f_line.height()).toAlignedRect();
+}
+
+void AOMessageDisplay::paintEvent(QPaintEvent *event)
+{
+  if (m_visible == 0)
+    return;
+
+  QPainter f_painter(this);
+  //text without a format of its own is drawn in the color the stylesheet gave us
+  f_painter.setPen(palette().color(foregroundRole()));
+  f_painter.translate(margin, margin - m_scroll);
+
+  QRectF f_exposed = QRectF(event->rect()).translated(-margin, m_scroll - margin);
+
+  for (int n_line = 0 ; n_line < m_layout.lineCount() ; ++n_line)
+  {
+    QTextLine f_line = m_layout.lineAt(n_line);
+
+    if (f_line.textStart() >= m_visible)
+      break;
+
+    if (f_line.y() + f_line.height() < f_exposed.top() || f_line.y() > f_exposed.bottom())
+      continue;
+
+    if (f_line.textStart() + f_line.textLength() <= m_visible)
+    {
+      f_line.draw(&f_painter, QPointF(0, 0));
+      continue;
+    }
+
+    //the line the reveal is in, cut off at the last visible character
+    qreal f_end = f_line.cursorToX(m_visible);
+
+    f_painter.save();
+    f_painter.setClipRect(QRectF(f_line.x(), f_line.y(), f_end - f_line.x(), f_line.height()));
+    f_line.draw(&f_painter, QPointF(0, 0));
+    f_painter.restore();
+  }
+}
+
+void AOMessageDisplay::resizeEvent(QResizeEvent *event)
+{
+  QWidget::resizeEvent(event);
+  do_layout();
+}
+
+void AOMessageDisplay::changeEvent(QEvent *event)
+{
+  QWidget::changeEvent(event);
+
+  if (event->type() == QEvent::FontChange)
+  {
+    do_layout();
+    update();
+  }
+}
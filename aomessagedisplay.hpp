@@ -0,0 +1,53 @@
+#ifndef AOMESSAGEDISPLAY_HPP
+#define AOMESSAGEDISPLAY_HPP
+
+#include <QWidget>
+#include <QTextLayout>
+#include <QVector>
+
+/**
+ * @brief The AOMessageDisplay shows the IC message in the chatbox as it ticks in.
+ * The whole message, colors included, is laid out once when it arrives. Every tick after that
+ * only uncovers one more character and repaints the line it is on, so a tick costs the same no
+ * matter how long the message is or how many colors it has.
+ */
+
+class AOMessageDisplay : public QWidget
+{
+  Q_OBJECT
+
+public:
+  AOMessageDisplay(QWidget *p_parent);
+
+  //Lays out p_message with p_formats on top of the widget's own color. Nothing is visible yet
+  void set_message(QString p_message, QVector<QTextLayout::FormatRange> p_formats);
+  void clear();
+
+  //Shows the first p_length characters of the message
+  void set_visible_length(int p_length);
+  int get_visible_length() {return m_visible;}
+
+  //same as the document margin QTextEdit had
+  static const int margin = 4;
+
+protected:
+  void paintEvent(QPaintEvent *event);
+  void resizeEvent(QResizeEvent *event);
+  void changeEvent(QEvent *event);
+
+private:
+  QTextLayout m_layout;
+
+  QString m_message;
+  QVector<QTextLayout::FormatRange> m_formats;
+
+  int m_visible = 0;
+  //how far the text is scrolled up, the last visible line is always in view
+  int m_scroll = 0;
+
+  void do_layout();
+  int get_scroll();
+  QRect get_line_rect(int n_line);
+};
+
+#endif // AOMESSAGEDISPLAY_HPP
@@ -2,102 +2,69 @@
 
 #include "file_functions.h"
 #include "courtroom.h"
-#include "misc_functions.h"
 
 AOMovie::AOMovie(QWidget *p_parent, AOApplication *p_ao_app) : QLabel(p_parent)
 {
   ao_app = p_ao_app;
 
-  m_movie = new QMovie();
+  m_player = new AOFramePlayer(this, ao_app);
+  //shouts and wt/ce never call set_play_once, they rely on the default
+  m_player->set_play_once(play_once);
 
-  this->setMovie(m_movie);
-
-  connect(m_movie, SIGNAL(frameChanged(int)), this, SLOT(frame_change(int)));
+  connect(m_player, SIGNAL(finished()), this, SLOT(on_finished()));
 }
 
 void AOMovie::set_play_once(bool p_play_once)
 {
   play_once = p_play_once;
+  m_player->set_play_once(play_once);
 }
 
 void AOMovie::play(QString p_file, QString p_char, QString p_custom_theme)
 {
-  m_movie->stop();
-
-  QVector<QString> f_vec;
+  m_player->stop();
 
-  QString file_path = "";
+  AOAssetResolver *resolver = ao_app->asset_resolver;
+  int f_exts = resolver->get_ext_set({".apng", ".gif", ".png"});
+  int char_layer = resolver->get_layer_set({"character:" + p_char});
 
-  QString custom_path;
+  QString custom_name;
   if (p_file == "custom")
-    custom_path = ao_app->get_character_path(p_char) + p_file;
+    custom_name = p_file;
   else
-    custom_path = ao_app->get_character_path(p_char) + p_file + "_bubble";
-
-  f_vec.push_back(custom_path);
-
-  QString overlay_path = ao_app->get_character_path(p_char) + "overlay/" + p_file;
-  QString custom_theme_path = ao_app->get_base_path() + "themes/" + p_custom_theme + "/" + p_file;
-  QString theme_path = ao_app->get_theme_path() + p_file;
-  QString default_theme_path = ao_app->get_default_theme_path() + p_file;
-  QString placeholder_path = ao_app->get_theme_path() + "placeholder";
-  QString default_placeholder_path = ao_app->get_default_theme_path() + "placeholder";
+    custom_name = p_file + "_bubble";
 
-  f_vec.push_back(overlay_path);
-  f_vec.push_back(custom_theme_path);
-  f_vec.push_back(theme_path);
-  f_vec.push_back(default_theme_path);
-  f_vec.push_back(placeholder_path);
-  f_vec.push_back(default_placeholder_path);
+  QString file_path = resolver->resolve(char_layer, custom_name, f_exts);
 
-  for(auto &f_file : f_vec)
-  {
-    bool found = false;
-    for (auto &ext : decltype(f_vec){".apng", ".gif", ".png"})
-    {
-      QString fullPath = f_file + ext;
-      found = file_exists(fullPath);
-      if (found)
-      {
-        file_path = fullPath;
-        break;
-      }
-    }
-
-    if (found)
-      break;
-  }
-
-  m_movie->setFileName(file_path);
+  if (file_path == "")
+    file_path = resolver->resolve(char_layer, "overlay/" + p_file, f_exts);
+  if (file_path == "")
+    file_path = resolver->resolve(resolver->get_layer_set({"custom_theme:" + p_custom_theme, "theme", "default_theme"}),
+                                  p_file, f_exts);
+  if (file_path == "")
+    file_path = resolver->resolve(resolver->get_layer_set({"theme", "default_theme"}), "placeholder", f_exts);
 
   this->show();
-  m_movie->setScaledSize(this->size());
-  m_movie->start();
+  m_player->play(file_path, this->size());
 }
 
 void AOMovie::stop()
 {
-  m_movie->stop();
+  m_player->stop();
   this->hide();
 }
 
-void AOMovie::frame_change(int n_frame)
+void AOMovie::on_finished()
 {
-  if (n_frame == (m_movie->frameCount() - 1) && play_once)
-  {
-    //we need this or else the last frame wont show
-    delay(m_movie->nextFrameDelay());
-
-    this->stop();
+  this->stop();
 
-    //signal connected to courtroom object, let it figure out what to do
-    emit done();
-  }
+  //signal connected to courtroom object, let it figure out what to do
+  emit done();
 }
 
 void AOMovie::combo_resize(int w, int h)
 {
   QSize f_size(w, h);
   this->resize(f_size);
-  m_movie->setScaledSize(f_size);
+  m_player->set_size(f_size);
 }
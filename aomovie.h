@@ -2,7 +2,8 @@
 #define AOMOVIE_H
 
 #include <QLabel>
-#include <QMovie>
+
+#include "aoframeplayer.hpp"
 
 class Courtroom;
 class AOApplication;
@@ -20,7 +21,7 @@ public:
   void stop();
 
 private:
-  QMovie *m_movie;
+  AOFramePlayer *m_player;
   AOApplication *ao_app = nullptr;
   bool play_once = true;
 
@@ -28,7 +29,7 @@ signals:
   void done();
 
 private slots:
-  void frame_change(int n_frame);
+  void on_finished();
 };
 
 #endif // AOMOVIE_H
@@ -1,39 +1,28 @@
 #include "aomusicplayer.h"
 
-#include <string.h>
-
-#include <QDebug>
-
 AOMusicPlayer::AOMusicPlayer(QObject *p_parent, AOApplication *p_ao_app)
     : AOAbstractPlayer(p_parent, p_ao_app)
-{}
-
-void AOMusicPlayer::play(QString p_file)
 {
-    QString f_file = ao_app->get_music_path(p_file);
-
-    stop();
-
-    m_file = f_file;
-
-    try { // create new song
-        AOBassHandle *handle = new AOBassHandle(m_file, false, this);
-        connect(this, &AOMusicPlayer::new_volume, handle, &AOBassHandle::set_volume);
-        connect(this, &AOMusicPlayer::stopping, handle, &AOBassHandle::stop);
+    connect(this, &AOMusicPlayer::new_volume, [this](int p_volume) {
+        ao_app->audio_engine->set_music_volume(p_volume);
+    });
+}
 
-        // delete previous
-        if (m_handle)
-            delete m_handle;
+void AOMusicPlayer::play(QString p_song)
+{
+    ao_app->audio_engine->play_music(p_song);
 
-        m_handle = handle;
-        m_handle->set_volume(get_volume());
-        m_handle->play();
-    } catch(const std::exception &e_exception) {
-        qDebug() << e_exception.what();
-    }
+    emit starting();
 }
 
 void AOMusicPlayer::stop()
 {
+    ao_app->audio_engine->stop_music();
+
     emit stopping();
 }
+
+void AOMusicPlayer::prefetch(QString p_song)
+{
+    ao_app->audio_engine->prefetch_music(p_song);
+}
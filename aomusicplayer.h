@@ -3,6 +3,13 @@
 
 #include "aoabstractplayer.hpp"
 
+/**
+ * @brief The AOMusicPlayer plays the courtroom music through the audio engine.
+ * The engine opens and prebuffers songs off the GUI thread and keeps the old song playing
+ * until the new one is ready. One more song can be opened ahead of time, so the one
+ * highlighted in the music list starts the moment it's asked for.
+ */
+
 class AOMusicPlayer : public AOAbstractPlayer
 {
     Q_OBJECT
@@ -10,12 +17,12 @@ class AOMusicPlayer : public AOAbstractPlayer
 public:
     AOMusicPlayer(QObject *p_parent, AOApplication *p_ao_app);
 
-    void play(QString p_file);
+    //p_song is the name the server uses, with or without an extension
+    void play(QString p_song);
     void stop();
 
-private:
-    AOBassHandle* m_handle = nullptr;
-    QString       m_file;
+    //Opens p_song in the background so that play() doesn't have to wait for it
+    void prefetch(QString p_song);
 };
 
 #endif // AOMUSICPLAYER_H
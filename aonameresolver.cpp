@@ -0,0 +1,153 @@
+#include "aonameresolver.hpp"
+
+#include "aoapplication.h"
+#include "aoassetindex.hpp"
+#include "file_functions.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QDebug>
+
+AONameResolver::AONameResolver(AOApplication *p_ao_app)
+  : QObject(p_ao_app), ao_app(p_ao_app)
+{
+  m_watcher = new QFileSystemWatcher(this);
+
+  connect(m_watcher, SIGNAL(fileChanged(QString)), this, SLOT(on_config_changed(QString)));
+  connect(m_watcher, SIGNAL(directoryChanged(QString)), this, SLOT(on_config_changed(QString)));
+}
+
+QString AONameResolver::get_showname(QString p_char)
+{
+  if (!m_shownames_loaded)
+    load_showname_overrides();
+
+  QHash<QString, QString>::const_iterator f_cached = m_resolved_shownames.constFind(p_char);
+  if (f_cached != m_resolved_shownames.constEnd())
+    return f_cached.value();
+
+  QString f_result = m_showname_overrides.value(p_char);
+  if (f_result == "")
+    f_result = ao_app->read_char_ini(p_char, "showname", "[Options]", "[Time]");
+
+  if (f_result == "")
+    f_result = p_char;
+
+  m_resolved_shownames.insert(p_char, f_result);
+
+  return f_result;
+}
+
+bool AONameResolver::is_rpc_char(QString p_char)
+{
+  if (!m_rpc_loaded)
+    load_rpc_chars();
+
+  return m_rpc_chars.contains(p_char.toLower());
+}
+
+void AONameResolver::invalidate()
+{
+  m_shownames_loaded = false;
+  m_rpc_loaded = false;
+
+  m_showname_overrides.clear();
+  m_resolved_shownames.clear();
+  m_rpc_chars.clear();
+}
+
+void AONameResolver::load_showname_overrides()
+{
+  m_showname_overrides.clear();
+  m_resolved_shownames.clear();
+  m_shownames_loaded = true;
+
+  watch_configs();
+
+  QString f_filename = ao_app->get_base_path() + shownames_ini;
+  QFile f_file(f_filename);
+  if (!f_file.open(QIODevice::ReadOnly))
+  { qDebug() << "Error reading" << f_filename; return; }
+
+  QTextStream in(&f_file);
+  while (!in.atEnd())
+  {
+    QStringList line_elements = in.readLine().split("=");
+    if (line_elements.size() < 2)
+      continue;
+
+    QString f_char = line_elements.at(0).trimmed();
+
+    //the first entry wins, same as the old linear scan
+    if (f_char == "" || m_showname_overrides.contains(f_char))
+      continue;
+
+    m_showname_overrides.insert(f_char, line_elements.at(1).trimmed());
+  }
+
+  f_file.close();
+}
+
+void AONameResolver::load_rpc_chars()
+{
+  m_rpc_chars.clear();
+  m_rpc_loaded = true;
+
+  watch_configs();
+
+  QString f_filename = ao_app->get_base_path() + rpc_ini;
+  QFile f_file(f_filename);
+  if (!f_file.open(QIODevice::ReadOnly))
+  { qDebug() << "Error reading" << f_filename; return; }
+
+  QTextStream in(&f_file);
+  while (!in.atEnd())
+  {
+    QStringList line_elements = in.readLine().trimmed().split("-");
+    if (line_elements.size() < 2)
+      continue;
+
+    m_rpc_chars.insert(line_elements.at(1).trimmed().toLower());
+  }
+
+  f_file.close();
+}
+
+void AONameResolver::watch_configs()
+{
+  //the directory is watched as well so that we notice the files being created or replaced
+  QStringList f_paths = {ao_app->get_base_path() + "configs",
+                         ao_app->get_base_path() + shownames_ini,
+                         ao_app->get_base_path() + rpc_ini};
+
+  for (QString f_path : f_paths)
+  {
+    if (m_watcher->files().contains(f_path) || m_watcher->directories().contains(f_path))
+      continue;
+
+    if (file_exists(f_path) || dir_exists(f_path))
+      m_watcher->addPath(f_path);
+  }
+}
+
+void AONameResolver::on_index_changed(QStringList p_changed)
+{
+  for (QHash<QString, QString>::iterator it = m_resolved_shownames.begin() ; it != m_resolved_shownames.end() ;)
+  {
+    if (AOAssetIndex::overlaps(ao_app->get_character_path(it.key()) + "char.ini", p_changed))
+      it = m_resolved_shownames.erase(it);
+    else
+      ++it;
+  }
+}
+
+void AONameResolver::on_config_changed(QString p_path)
+{
+  Q_UNUSED(p_path)
+
+  invalidate();
+
+  //some editors save by replacing the file, which drops it from the watcher
+  watch_configs();
+}
@@ -0,0 +1,66 @@
+#ifndef AONAMERESOLVER_HPP
+#define AONAMERESOLVER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QFileSystemWatcher>
+
+class AOApplication;
+
+/**
+ * @brief The AONameResolver turns character folder names into the names shown to the user.
+ * The override tables (configs/shownames.ini and configs/rpccharlist.ini) are parsed once
+ * into hash tables and only reparsed after the files change on disk. Shownames that came from
+ * a char.ini are forgotten when the asset index reports that character's folder changed.
+ */
+
+class AONameResolver : public QObject
+{
+  Q_OBJECT
+
+public:
+  AONameResolver(AOApplication *p_ao_app);
+
+  //Returns the showname of p_char: shownames.ini override, then char.ini showname, then p_char itself
+  QString get_showname(QString p_char);
+
+  //Returns true if p_char is listed in rpccharlist.ini
+  bool is_rpc_char(QString p_char);
+
+  //Drops every cached lookup, the tables are reloaded on the next query
+  void invalidate();
+
+private:
+  AOApplication *ao_app = nullptr;
+
+  QFileSystemWatcher *m_watcher;
+
+  const QString shownames_ini = "configs/shownames.ini";
+  const QString rpc_ini = "configs/rpccharlist.ini";
+
+  bool m_shownames_loaded = false;
+  bool m_rpc_loaded = false;
+
+  //showname overrides, keyed by character folder name
+  QHash<QString, QString> m_showname_overrides;
+  //fully resolved shownames, this also remembers the char.ini lookups
+  QHash<QString, QString> m_resolved_shownames;
+  //lowercase names of the characters that need the second discord application ID
+  QSet<QString> m_rpc_chars;
+
+  void load_showname_overrides();
+  void load_rpc_chars();
+  void watch_configs();
+
+public slots:
+  //forgets the shownames of the characters under the paths the asset index reported
+  void on_index_changed(QStringList p_changed);
+
+private slots:
+  void on_config_changed(QString p_path);
+};
+
+#endif // AONAMERESOLVER_HPP
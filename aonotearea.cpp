@@ -65,15 +65,6 @@ void Courtroom::on_add_button_clicked()
 void Courtroom::set_note_files()
 {
   QString filename = ao_app->get_base_path() + "configs/filesabstract.ini";
-  QFile config_file(filename);
-
-  if(!config_file.open(QIODevice::ReadOnly | QIODevice::Text))
-  {
-      qDebug() << "Couldn't open" << filename;
-      return;
-  }
-
-  QTextStream in(&config_file);
 
   QByteArray t = "";
 
@@ -86,16 +77,5 @@ void Courtroom::set_note_files()
       t += QString::number(i) + " = " + f_filestring + " = " + f_filename + "\n\n";
     }
 
-
-  config_file.close();
-
-  QFile ex(filename);
-  if(!ex.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
-  {
-      qDebug() << "Couldn't open" << filename;
-      return;
-  }
-
-  ex.write(t);
-  ex.close();
+  ao_app->file_writer->write_file(filename, t);
 }
@@ -3,3 +3,10 @@
 AONotepad::AONotepad(QWidget* p_parent, AOApplication *p_ao_app)
   : QTextEdit(p_parent), ao_app(p_ao_app)
 {}
+
+void AONotepad::focusOutEvent(QFocusEvent *p_event)
+{
+  QTextEdit::focusOutEvent(p_event);
+
+  emit focus_lost();
+}
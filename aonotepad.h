@@ -2,6 +2,7 @@
 #define AONOTEPAD_H
 
 #include <QTextEdit>
+#include <QFocusEvent>
 
 #include "aoapplication.h"
 
@@ -12,6 +13,12 @@ class AONotepad : public QTextEdit
 public:
   AONotepad(QWidget* p_parent, AOApplication *p_ao_app);
 
+signals:
+  void focus_lost();
+
+protected:
+  void focusOutEvent(QFocusEvent *p_event);
+
 private:
   AOApplication *ao_app = nullptr;
 };
@@ -23,6 +23,11 @@ void Courtroom::on_file_selected()
 
   AOButton *f_button = static_cast<AOButton*>(sender());
   AONotePicker *f_notepicker = static_cast<AONotePicker*>(f_button->parent());
+
+  //unsaved edits belong to the file we're switching away from
+  if(note_dirty)
+    save_note();
+
   current_file = f_notepicker->real_file;
   load_note();
   f_button->set_image("note_select_selected.png");
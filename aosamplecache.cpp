@@ -0,0 +1,160 @@
+#include "aosamplecache.hpp"
+
+#include "aoassetindex.hpp"
+#include "file_functions.h"
+
+#include <QDebug>
+
+AOSampleCache::AOSampleCache(int p_budget, int p_channels)
+{
+  m_samples.setMaxCost(p_budget);
+  m_channels = p_channels;
+}
+
+AOSampleCache::~AOSampleCache()
+{
+  //nothing gets to finish playing anymore
+  m_closing = true;
+  m_samples.clear();
+
+  for (HSAMPLE f_handle : m_retired)
+    BASS_SampleFree(f_handle);
+}
+
+HSAMPLE AOSampleCache::get_sample(QString p_file)
+{
+  if (sample *f_cached = m_samples.object(p_file))
+  {
+    ++m_hits;
+    return f_cached->handle;
+  }
+
+  if (m_oversized.contains(p_file))
+    return 0;
+
+  ++m_misses;
+
+  collect_retired();
+
+  bool is_packed = is_packed_asset(p_file);
+  QByteArray f_data;
+  if (is_packed)
+    f_data = read_asset(p_file);
+
+  //a long song used as an sfx isn't decoded just to find out it doesn't fit
+  if (get_decoded_size(p_file, f_data) > m_samples.maxCost())
+  {
+    m_oversized.insert(p_file);
+    return 0;
+  }
+
+  //the oldest channel of the sample is taken over once they're all busy
+  DWORD f_flags = BASS_SAMPLE_OVER_POS;
+  HSAMPLE f_handle;
+
+  //bass copies the data into the sample
+  if (is_packed)
+    f_handle = BASS_SampleLoad(TRUE, f_data.constData(), 0, f_data.size(), m_channels, f_flags);
+  else
+    f_handle = BASS_SampleLoad(FALSE, p_file.utf16(), 0, 0, m_channels, f_flags | BASS_UNICODE);
+
+  if (!f_handle)
+  {
+    qDebug() << p_file << "could not be loaded as a sample, error" << BASS_ErrorGetCode();
+    return 0;
+  }
+
+  BASS_SAMPLE f_info;
+  BASS_SampleGetInfo(f_handle, &f_info);
+
+  //files bass couldn't measure up front
+  if (f_info.length > DWORD(m_samples.maxCost()))
+  {
+    BASS_SampleFree(f_handle);
+    m_oversized.insert(p_file);
+    return 0;
+  }
+
+  sample *f_sample = new sample();
+  f_sample->handle = f_handle;
+  f_sample->cache = this;
+  m_samples.insert(p_file, f_sample, int(f_info.length));
+
+  return f_handle;
+}
+
+void AOSampleCache::remove(QStringList p_changed)
+{
+  for (QString f_file : m_samples.keys())
+  {
+    if (AOAssetIndex::overlaps(f_file, p_changed))
+      m_samples.remove(f_file);
+  }
+
+  for (QSet<QString>::iterator it = m_oversized.begin() ; it != m_oversized.end() ;)
+  {
+    if (AOAssetIndex::overlaps(*it, p_changed))
+      it = m_oversized.erase(it);
+    else
+      ++it;
+  }
+
+  collect_retired();
+}
+
+void AOSampleCache::release(HSAMPLE p_handle)
+{
+  //freeing a sample stops its channels
+  if (!m_closing && is_playing(p_handle))
+    m_retired.append(p_handle);
+  else
+    BASS_SampleFree(p_handle);
+}
+
+void AOSampleCache::collect_retired()
+{
+  for (int n_sample = m_retired.size() - 1 ; n_sample >= 0 ; --n_sample)
+  {
+    if (is_playing(m_retired.at(n_sample)))
+      continue;
+
+    BASS_SampleFree(m_retired.at(n_sample));
+    m_retired.remove(n_sample);
+  }
+}
+
+bool AOSampleCache::is_playing(HSAMPLE p_handle)
+{
+  QVector<HCHANNEL> f_channels(m_channels);
+  int f_count = int(BASS_SampleGetChannels(p_handle, f_channels.data()));
+
+  for (int n_channel = 0 ; n_channel < f_count ; ++n_channel)
+  {
+    if (BASS_ChannelIsActive(f_channels.at(n_channel)) != BASS_ACTIVE_STOPPED)
+      return true;
+  }
+
+  return false;
+}
+
+qint64 AOSampleCache::get_decoded_size(QString p_file, const QByteArray &p_data)
+{
+  //only the header is read, a decoding stream doesn't decode anything until it's asked to
+  HSTREAM f_probe;
+
+  if (!p_data.isEmpty())
+    f_probe = BASS_StreamCreateFile(TRUE, p_data.constData(), 0, p_data.size(), BASS_STREAM_DECODE);
+  else
+    f_probe = BASS_StreamCreateFile(FALSE, p_file.utf16(), 0, 0, BASS_STREAM_DECODE | BASS_UNICODE);
+
+  if (!f_probe)
+    return -1;
+
+  QWORD f_length = BASS_ChannelGetLength(f_probe, BASS_POS_BYTE);
+  BASS_StreamFree(f_probe);
+
+  if (f_length == QWORD(-1))
+    return -1;
+
+  return qint64(f_length);
+}
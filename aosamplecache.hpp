@@ -0,0 +1,71 @@
+#ifndef AOSAMPLECACHE_HPP
+#define AOSAMPLECACHE_HPP
+
+#include <QString>
+#include <QStringList>
+#include <QCache>
+#include <QSet>
+#include <QVector>
+
+#include <bass.h>
+
+/**
+ * @brief The AOSampleCache keeps short sound effects decoded in memory.
+ * Every file is decoded into a BASS sample the first time it's played and kept until the
+ * byte budget runs out, then the least recently played ones go first. Files that wouldn't
+ * fit at all are remembered so they're streamed instead of decoded over and over.
+ * A sample that is dropped while it still plays is only freed once it's done.
+ */
+
+class AOSampleCache
+{
+public:
+  AOSampleCache(int p_budget, int p_channels);
+  ~AOSampleCache();
+
+  //Returns the sample of p_file, decoding it if it isn't cached. 0 if it couldn't be loaded
+  //or is too big to keep, is_oversized() tells which
+  HSAMPLE get_sample(QString p_file);
+  bool is_oversized(QString p_file) {return m_oversized.contains(p_file);}
+
+  //Drops the samples of files under p_changed, see AOAssetIndex::index_changed()
+  void remove(QStringList p_changed);
+
+  int get_hits() {return m_hits;}
+  int get_misses() {return m_misses;}
+  int get_bytes() {return m_samples.totalCost();}
+  //bass samples we hold, the retired ones that still play included
+  int get_handle_count() {return m_samples.count() + m_retired.size();}
+
+private:
+  struct sample
+  {
+    HSAMPLE handle = 0;
+    AOSampleCache *cache = nullptr;
+    ~sample() {cache->release(handle);}
+  };
+
+  //samples that were dropped while they played, they have to outlive m_samples
+  QVector<HSAMPLE> m_retired;
+  bool m_closing = false;
+
+  //file -> sample, the cost is the decoded size in bytes
+  QCache<QString, sample> m_samples;
+  QSet<QString> m_oversized;
+
+  //channels per sample, the same effect can overlap itself this often
+  int m_channels;
+
+  int m_hits = 0;
+  int m_misses = 0;
+
+  //frees p_handle, or retires it if a channel of it is still playing
+  void release(HSAMPLE p_handle);
+  //frees the retired samples that are done playing
+  void collect_retired();
+  bool is_playing(HSAMPLE p_handle);
+  //how many bytes p_file takes decoded, -1 if bass can't tell without decoding it
+  static qint64 get_decoded_size(QString p_file, const QByteArray &p_data);
+};
+
+#endif // AOSAMPLECACHE_HPP
@@ -3,91 +3,38 @@
 #include "courtroom.h"
 
 #include "file_functions.h"
+#include "aoviewport.hpp"
 
 // core
 #include <QDebug>
 
-// gui
-#include <QMovie>
-
 AOScene::AOScene(QWidget *parent, AOApplication *p_ao_app) : QLabel(parent)
 {
   m_parent = parent;
-  m_movie = new QMovie(this);
   ao_app = p_ao_app;
+  m_player = new AOFramePlayer(this, ao_app);
 }
 
-void AOScene::set_image(QString p_image)
+void AOScene::set_frames(QString p_path, frame_set_ptr p_frames)
 {
-  QString animated_background_path = ao_app->get_background_path() + p_image;
-  QString background_path = ao_app->get_background_path() + p_image + ".png";
-  QString default_path = ao_app->get_default_background_path() + p_image;
-
-  for (auto& ext : QVector<QString>{".apng", ".gif"})
-  {
-    QString full_path = animated_background_path + ext;
-    if (file_exists(full_path))
-      break;
-  }
-
-  QPixmap animated_background(animated_background_path);
-  QPixmap background(background_path);
-  QPixmap default_bg(default_path);
+  //same side as the last message, no reason to start over
+  if (p_frames && m_player->get_frames() == p_frames)
+    return;
 
-  int w = this->width();
-  int h = this->height();
+  AOViewport::clear_pixmap(this);
 
-  // remove movie
-  this->clear();
-  this->setMovie(nullptr);
-  // stop current movie
-  m_movie->stop();
-  m_movie->setFileName(animated_background_path);
-  m_movie->setScaledSize(QSize(w, h));
-
-  if (m_movie->isValid())
-  {
-    this->setMovie(m_movie);
-    m_movie->start();
-  }
-  else if (file_exists(background_path))
-  {
-    this->setPixmap(background.scaled(w, h));
-  }
+  //animated or not, the player takes care of it. a still image just never advances
+  if (p_frames)
+    m_player->play_frames(p_frames, p_path, this->size());
   else
-  {
-    this->setPixmap(default_bg.scaled(w, h));
-  }
+    m_player->stop();
 }
 
-void AOScene::set_legacy_desk(QString p_image)
+void AOScene::set_legacy_desk(QPixmap p_desk)
 {
-  //vanilla desks vary in both width and height. in order to make that work with viewport rescaling,
-  //some INTENSE math is needed.
-
-  QString desk_path = ao_app->get_background_path() + p_image;
-  QString default_path = ao_app->get_default_background_path() + p_image;
-
-  QPixmap f_desk;
-
-  if (file_exists(desk_path))
-    f_desk.load(desk_path);
-  else
-    f_desk.load(default_path);
-
-  int vp_width = m_parent->width();
-  int vp_height = m_parent->height();
-
-  //double y_modifier = 147 / 192;
-  //double w_modifier = vp_width / 256;
-  double h_modifier = vp_height / 192;
-
-  //int final_y = y_modifier * vp_height;
-  //int final_w = w_modifier * f_desk.width();
-  int final_h = h_modifier * f_desk.height();
+  //scaled to the viewport by the scene cache already, only the height varies
+  m_player->stop();
 
-  //this->resize(final_w, final_h);
-  //this->setPixmap(f_desk.scaled(final_w, final_h));
-  this->resize(vp_width, final_h);
-  this->setPixmap(f_desk.scaled(vp_width, final_h));
+  this->resize(m_parent->width(), p_desk.height());
+  AOViewport::set_pixmap(this, p_desk);
 }
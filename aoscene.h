@@ -3,6 +3,8 @@
 
 #include <QLabel>
 
+#include "aoframeplayer.hpp"
+
 class Courtroom;
 class AOApplication;
 
@@ -12,12 +14,13 @@ class AOScene : public QLabel
 public:
   explicit AOScene(QWidget *parent, AOApplication *p_ao_app);
 
-  void set_image(QString p_image);
-  void set_legacy_desk(QString p_image);
+  //Shows p_frames, prepared by the scene cache. Keeps going if they are up already
+  void set_frames(QString p_path, frame_set_ptr p_frames);
+  void set_legacy_desk(QPixmap p_desk);
 
 private:
   QWidget*       m_parent = nullptr;
-  QMovie*        m_movie = nullptr;
+  AOFramePlayer* m_player = nullptr;
   AOApplication* ao_app = nullptr;
 
 };
@@ -0,0 +1,234 @@
+#include "aoscenecache.hpp"
+
+#include "aoapplication.h"
+#include "file_functions.h"
+#include "aoblit.hpp"
+
+#include <QRunnable>
+#include <QMutexLocker>
+#include <QDebug>
+
+class AOLegacyDeskTask : public QRunnable
+{
+public:
+  AOLegacyDeskTask(AOSceneCache *p_cache, legacy_desk_ptr p_desk, QString p_path, QSize p_size)
+    : m_cache(p_cache), m_desk(p_desk), m_path(p_path), m_size(p_size) {}
+
+  void run()
+  {
+    QImage f_image;
+    if (m_path != "")
+      f_image.loadFromData(read_asset(m_path));
+
+    //vanilla desks vary in both width and height. in order to make that work with viewport rescaling,
+    //some INTENSE math is needed.
+    double h_modifier = m_size.height() / 192.0;
+    int final_h = h_modifier * f_image.height();
+
+    if (!f_image.isNull())
+      f_image = scale_frame(f_image, QSize(m_size.width(), final_h), false);
+
+    {
+      QMutexLocker locker(&m_desk->mutex);
+      m_desk->image = f_image;
+      m_desk->finished = true;
+    }
+
+    //the cache waits for us before it goes away
+    QMetaObject::invokeMethod(m_cache, "legacy_desk_finished", Qt::QueuedConnection);
+  }
+
+private:
+  AOSceneCache *m_cache;
+  legacy_desk_ptr m_desk;
+  QString m_path;
+  QSize m_size;
+};
+
+AOSceneCache::AOSceneCache(AOApplication *p_ao_app, QObject *p_parent) : QObject(p_parent)
+{
+  ao_app = p_ao_app;
+
+  m_pool.setMaxThreadCount(1);
+}
+
+AOSceneCache::~AOSceneCache()
+{
+  m_pool.waitForDone();
+  release_all();
+}
+
+void AOSceneCache::get_image_names(QString p_side, bool p_ao2, QString &p_background, QString &p_desk)
+{
+  if (p_side == "def")
+  {
+    p_background = "defenseempty";
+    if (p_ao2)
+      p_desk = "defensedesk";
+    else
+      p_desk = "bancodefensa";
+  }
+  else if (p_side == "pro")
+  {
+    p_background = "prosecutorempty";
+    if (p_ao2)
+      p_desk = "prosecutiondesk";
+    else
+      p_desk = "bancoacusacion";
+  }
+  else if (p_side == "jud")
+  {
+    p_background = "judgestand";
+    p_desk = "judgedesk";
+  }
+  else if (p_side == "hld")
+  {
+    p_background = "helperstand";
+    p_desk = "helperdesk";
+  }
+  else if (p_side == "hlp")
+  {
+    p_background = "prohelperstand";
+    p_desk = "prohelperdesk";
+  }
+  else
+  {
+    //witness is default if pos is invalid
+    p_background = "witnessempty";
+    if (p_ao2)
+      p_desk = "stand";
+    else
+      p_desk = "estrado";
+  }
+}
+
+QString AOSceneCache::find_image(QString p_background_path, QString p_name)
+{
+  QVector<QString> f_exts = {".apng", ".gif", ".png"};
+
+  for (QString f_ext : f_exts)
+  {
+    if (file_exists(p_background_path + p_name + f_ext))
+      return p_background_path + p_name + f_ext;
+  }
+
+  QString f_default_path = ao_app->get_default_background_path();
+
+  for (QString f_ext : f_exts)
+  {
+    if (file_exists(f_default_path + p_name + f_ext))
+      return f_default_path + p_name + f_ext;
+  }
+
+  return "";
+}
+
+void AOSceneCache::load(QString p_background_path, bool p_ao2, QSize p_size)
+{
+  QString f_key = p_background_path + (p_ao2 ? "|ao2|" : "|legacy|") +
+                  QString::number(p_size.width()) + "x" + QString::number(p_size.height());
+
+  if (f_key == m_key)
+    return;
+
+  release_all();
+  m_key = f_key;
+  m_background_path = p_background_path;
+
+  //several sides tend to share the same desk
+  QHash<QString, legacy_desk_ptr> f_legacy_desks;
+
+  for (QString f_side : QStringList{"def", "pro", "wit", "jud", "hld", "hlp"})
+  {
+    QString f_background;
+    QString f_desk;
+    get_image_names(f_side, p_ao2, f_background, f_desk);
+
+    side f_scene;
+    f_scene.background = find_image(p_background_path, f_background);
+    f_scene.desk = find_image(p_background_path, f_desk);
+
+    //held on to until the next background, so the decodes don't get cancelled and the frames stay around
+    if (f_scene.background != "")
+    {
+      f_scene.background_frames = ao_app->frame_cache->get_frames(f_scene.background, false, p_size);
+      ao_app->frame_cache->acquire(f_scene.background_frames);
+    }
+
+    if (f_scene.desk != "")
+    {
+      f_scene.desk_frames = ao_app->frame_cache->get_frames(f_scene.desk, false, p_size);
+      ao_app->frame_cache->acquire(f_scene.desk_frames);
+    }
+
+    //ao2 backgrounds never show a legacy desk
+    f_scene.legacy_desk = f_legacy_desks.value(f_scene.desk);
+    if (!p_ao2 && !f_scene.legacy_desk)
+    {
+      f_scene.legacy_desk = std::make_shared<AOLegacyDesk>();
+      f_legacy_desks.insert(f_scene.desk, f_scene.legacy_desk);
+      m_pool.start(new AOLegacyDeskTask(this, f_scene.legacy_desk, f_scene.desk, p_size));
+    }
+
+    m_sides.insert(f_side, f_scene);
+  }
+
+  qDebug() << "scene cache: prepared" << m_sides.size() << "sides of" << p_background_path;
+}
+
+AOSceneCache::side AOSceneCache::get_side(QString p_side)
+{
+  if (m_sides.contains(p_side))
+    return m_sides.value(p_side);
+
+  return m_sides.value("wit");
+}
+
+QPixmap AOSceneCache::get_legacy_desk(legacy_desk_ptr p_desk)
+{
+  if (!p_desk)
+    return QPixmap();
+
+  AOLegacyDesk *f_desk = p_desk.get();
+
+  if (!f_desk->converted)
+  {
+    QMutexLocker locker(&f_desk->mutex);
+
+    //set_scene comes back for it once it's scaled
+    if (!f_desk->finished)
+      return QPixmap();
+
+    f_desk->pixmap = QPixmap::fromImage(f_desk->image);
+    f_desk->image = QImage();
+    f_desk->converted = true;
+  }
+
+  return f_desk->pixmap;
+}
+
+void AOSceneCache::invalidate()
+{
+  m_key = "";
+}
+
+void AOSceneCache::on_index_changed(QStringList p_changed)
+{
+  //missing images fall back to the default background
+  if (AOAssetIndex::overlaps(m_background_path, p_changed) ||
+      AOAssetIndex::overlaps(ao_app->get_default_background_path(), p_changed))
+    invalidate();
+}
+
+void AOSceneCache::release_all()
+{
+  for (const side &f_scene : m_sides)
+  {
+    if (f_scene.background_frames)
+      ao_app->frame_cache->release(f_scene.background_frames);
+    if (f_scene.desk_frames)
+      ao_app->frame_cache->release(f_scene.desk_frames);
+  }
+
+  m_sides.clear();
+}
@@ -0,0 +1,99 @@
+#ifndef AOSCENECACHE_HPP
+#define AOSCENECACHE_HPP
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QSize>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QMutex>
+#include <QThreadPool>
+
+#include <memory>
+
+#include "aoframecache.hpp"
+
+class AOApplication;
+class AOLegacyDeskTask;
+
+struct AOLegacyDesk
+{
+  //guards image and finished, the worker fills them in
+  QMutex mutex;
+
+  QImage image;
+  bool finished = false;
+
+  //converted on the GUI thread the first time it's needed
+  QPixmap pixmap;
+  bool converted = false;
+};
+
+typedef std::shared_ptr<AOLegacyDesk> legacy_desk_ptr;
+
+/**
+ * @brief The AOSceneCache prepares every side of the current background as soon as it's set.
+ * The background and desk of each position are resolved once and their frames decoded in the
+ * background at the viewport size, and the legacy desk is scaled on a worker thread. When a
+ * message switches sides, set_scene only has to look the side up. A legacy desk that isn't
+ * scaled yet is left empty until legacy_desk_finished() says it's there.
+ */
+
+class AOSceneCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOSceneCache(AOApplication *p_ao_app, QObject *p_parent = nullptr);
+  ~AOSceneCache();
+
+  struct side
+  {
+    QString background;
+    frame_set_ptr background_frames;
+
+    QString desk;
+    frame_set_ptr desk_frames;
+
+    legacy_desk_ptr legacy_desk;
+  };
+
+  //Starts preparing every side of the background in p_background_path for a viewport of p_size.
+  //Does nothing if that is what's prepared already
+  void load(QString p_background_path, bool p_ao2, QSize p_size);
+
+  //Returns the prepared scene for p_side, anything unknown is the witness stand
+  side get_side(QString p_side);
+
+  //Returns the scaled legacy desk p_desk, or an empty pixmap if the worker isn't done with it yet
+  QPixmap get_legacy_desk(legacy_desk_ptr p_desk);
+
+  //Which background and desk image a position uses, without extension
+  static void get_image_names(QString p_side, bool p_ao2, QString &p_background, QString &p_desk);
+
+signals:
+  //a legacy desk was scaled, emitted on the GUI thread
+  void legacy_desk_finished();
+
+public slots:
+  //the files behind the prepared scenes changed, everything gets prepared again on the next load
+  void invalidate();
+  //p_changed are the paths the asset index reported, only the backgrounds in use matter
+  void on_index_changed(QStringList p_changed);
+
+private:
+  AOApplication *ao_app = nullptr;
+
+  QString m_key;
+  QString m_background_path;
+  QHash<QString, side> m_sides;
+
+  QThreadPool m_pool;
+
+  QString find_image(QString p_background_path, QString p_name);
+  void release_all();
+};
+
+#endif // AOSCENECACHE_HPP
@@ -6,24 +6,22 @@
 
 AOSfxPlayer::AOSfxPlayer(QObject *p_parent, AOApplication *p_ao_app)
     : AOAbstractPlayer(p_parent, p_ao_app)
-{}
+{
+    connect(this, &AOSfxPlayer::new_volume, [this](int p_volume) {
+        ao_app->audio_engine->set_volume(get_id(), p_volume);
+    });
+}
 
 void AOSfxPlayer::play(QString p_name)
 {
     QString f_file = ao_app->get_sounds_path() + p_name.toLower();
 
-    try {
-        AOBassHandle *handle = new AOBassHandle(f_file, true, this);
-        connect(this, &AOSfxPlayer::new_volume, handle, &AOBassHandle::set_volume);
-        connect(this, &AOSfxPlayer::stopping, handle, &AOBassHandle::stop);
-        handle->set_volume(get_volume());
-        handle->play();
-    } catch(const std::exception &e_exception) {
-        qDebug() << e_exception.what();
-    }
+    //decoded once, played out of memory after that
+    ao_app->audio_engine->play_file(f_file, AOAudioEngine::SFX, get_id(), get_volume());
 }
 
 void AOSfxPlayer::stop()
 {
     emit stopping();
+    ao_app->audio_engine->stop(get_id());
 }
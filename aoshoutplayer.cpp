@@ -1,45 +1,25 @@
 #include "aoshoutplayer.hpp"
 #include "file_functions.h"
 
-#include <QDebug>
-
 AOShoutPlayer::AOShoutPlayer(QObject *p_parent, AOApplication *p_ao_app)
     : AOAbstractPlayer(p_parent, p_ao_app)
-{}
+{
+    connect(this, &AOShoutPlayer::new_volume, [this](int p_volume) {
+        ao_app->audio_engine->set_volume(get_id(), p_volume);
+    });
+}
 
 void AOShoutPlayer::play(QString p_name, QString p_char)
 {
-    QString f_file;
-
-    QString char_path = ao_app->get_character_path(p_char) + p_name.toLower();
-    QString theme_path = ao_app->get_theme_path() + p_name.toLower();
-    QString default_theme_path = ao_app->get_default_theme_path() + p_name.toLower();
-
-    qDebug() << char_path;
-    qDebug() << theme_path;
-    qDebug() << default_theme_path;
-
-    if(file_exists(char_path))
-      f_file = char_path;
-    else if (file_exists(theme_path))
-      f_file = theme_path;
-    else if (file_exists(default_theme_path))
-      f_file = default_theme_path;
-    else
-      f_file = "";
+    QString f_file = ao_app->asset_resolver->resolve({"character:" + p_char, "theme", "default_theme"},
+                                                     p_name.toLower());
 
-    try {
-        AOBassHandle *handle = new AOBassHandle(f_file, true, this);
-        connect(this, &AOShoutPlayer::new_volume, handle, &AOBassHandle::set_volume);
-        connect(this, &AOShoutPlayer::stopping, handle, &AOBassHandle::stop);
-        handle->set_volume(get_volume());
-        handle->play();
-    } catch(const std::exception &e_exception) {
-        qDebug() << e_exception.what();
-    }
+    //shouts cut off anything else once the mixer is full
+    ao_app->audio_engine->play_file(f_file, AOAudioEngine::SHOUT, get_id(), get_volume());
 }
 
 void AOShoutPlayer::stop()
 {
     emit stopping();
+    ao_app->audio_engine->stop(get_id());
 }
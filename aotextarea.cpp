@@ -2,12 +2,60 @@
 
 #include <QScrollBar>
 #include <QTextCursor>
-#include <QRegExp>
+#include <QTextDocument>
 #include <QDebug>
 
-AOTextArea::AOTextArea(QWidget *p_parent) : QTextBrowser(p_parent)
+//same characters \b counts as part of a word
+static bool is_word_char(QChar p_char)
+{
+  return p_char.isLetterOrNumber() || p_char.isMark() || p_char == '_';
+}
+
+//Finds the next http(s) link at or after p_from, what "\b(https?://\S+\.\S+)\b" used to match.
+//Returns where it starts or -1, and its length in p_length
+static int find_url(const QString &p_text, int p_from, int &p_length)
 {
+  const int f_size = p_text.size();
+
+  for (int n_pos = p_text.indexOf("http", p_from) ; n_pos != -1 ; n_pos = p_text.indexOf("http", n_pos + 1))
+  {
+    if (n_pos > 0 && is_word_char(p_text.at(n_pos - 1)))
+      continue;
+
+    int f_host = n_pos + 4;
+    if (f_host < f_size && p_text.at(f_host) == 's')
+      ++f_host;
+
+    if (p_text.midRef(f_host, 3) != QLatin1String("://"))
+      continue;
+
+    f_host += 3;
+
+    int f_end = f_host;
+    while (f_end < f_size && !p_text.at(f_end).isSpace())
+      ++f_end;
+
+    //trailing punctuation isn't part of it
+    while (f_end > f_host && !is_word_char(p_text.at(f_end - 1)))
+      --f_end;
+
+    //needs a dot with something on both sides
+    int f_dot = p_text.indexOf('.', f_host + 1);
+    if (f_dot == -1 || f_dot >= f_end - 1)
+      continue;
+
+    p_length = f_end - n_pos;
+    return n_pos;
+  }
+
+  return -1;
+}
 
+AOTextArea::AOTextArea(QWidget *p_parent) : QTextBrowser(p_parent)
+{
+  //the document drops its oldest blocks as new ones come in, and an undo stack would keep them alive anyway
+  document()->setUndoRedoEnabled(false);
+  document()->setMaximumBlockCount(block_limit);
 }
 
 void AOTextArea::append_chatmessage(QString p_name, QString p_message)
@@ -16,16 +64,19 @@ void AOTextArea::append_chatmessage(QString p_name, QString p_message)
   const int old_scrollbar_value = this->verticalScrollBar()->value();
   const bool is_scrolled_down = old_scrollbar_value == this->verticalScrollBar()->maximum();
 
-  this->moveCursor(QTextCursor::End);
+  QTextCursor f_cursor(document());
+  f_cursor.movePosition(QTextCursor::End);
+
+  if (!document()->isEmpty())
+    f_cursor.insertBlock();
 
-  this->append("");
-  this->insertHtml("<b>" + p_name.toHtmlEscaped() + "</b>:&nbsp;");
+  QTextCharFormat f_bold;
+  f_bold.setFontWeight(QFont::Bold);
 
-  //cheap workarounds ahoy
-  p_message += " ";
-  QString result = p_message.toHtmlEscaped().replace("\n", "<br>").replace(omnis_dank_url_regex, "<a href='\\1'>\\1</a>" );
+  f_cursor.insertText(p_name, f_bold);
+  f_cursor.insertText(QString(":") + QChar(QChar::Nbsp), QTextCharFormat());
 
-  this->insertHtml(result);
+  append_linked_text(f_cursor, p_message, QTextCharFormat());
 
   this->auto_scroll(old_cursor, old_scrollbar_value, is_scrolled_down);
 }
@@ -36,18 +87,47 @@ void AOTextArea::append_error(QString p_message)
   const int old_scrollbar_value = this->verticalScrollBar()->value();
   const bool is_scrolled_down = old_scrollbar_value == this->verticalScrollBar()->maximum();
 
-  this->moveCursor(QTextCursor::End);
+  QTextCursor f_cursor(document());
+  f_cursor.movePosition(QTextCursor::End);
 
-  this->append("");
+  if (!document()->isEmpty())
+    f_cursor.insertBlock();
 
-  p_message += " ";
-  QString result = p_message.replace("\n", "<br>").replace(omnis_dank_url_regex, "<a href='\\1'>\\1</a>" );
+  QTextCharFormat f_red;
+  f_red.setForeground(Qt::red);
 
-  this->insertHtml("<font color='red'>" + result + "</font>");
+  append_linked_text(f_cursor, p_message, f_red);
 
   this->auto_scroll(old_cursor, old_scrollbar_value, is_scrolled_down);
 }
 
+void AOTextArea::append_linked_text(QTextCursor &p_cursor, QString p_text, QTextCharFormat p_format)
+{
+  //line breaks inside a message don't start new blocks, so one message is always one block
+  p_text.replace('\n', QChar::LineSeparator);
+
+  QTextCharFormat f_link = p_format;
+  f_link.setAnchor(true);
+  f_link.setForeground(palette().link());
+  f_link.setFontUnderline(true);
+
+  int f_length = 0;
+  int f_done = 0;
+
+  for (int f_url = find_url(p_text, 0, f_length) ; f_url != -1 ; f_url = find_url(p_text, f_done, f_length))
+  {
+    p_cursor.insertText(p_text.mid(f_done, f_url - f_done), p_format);
+
+    QString f_href = p_text.mid(f_url, f_length);
+    f_link.setAnchorHref(f_href);
+    p_cursor.insertText(f_href, f_link);
+
+    f_done = f_url + f_length;
+  }
+
+  p_cursor.insertText(p_text.mid(f_done), p_format);
+}
+
 void AOTextArea::auto_scroll(QTextCursor old_cursor, int old_scrollbar_value, bool is_scrolled_down)
 {
   if (old_cursor.hasSelection() || !is_scrolled_down)
@@ -2,6 +2,7 @@
 #define AOTEXTAREA_H
 
 #include <QTextBrowser>
+#include <QTextCharFormat>
 
 class AOTextArea : public QTextBrowser
 {
@@ -11,9 +12,11 @@ public:
   void append_chatmessage(QString p_name, QString p_message);
   void append_error(QString p_message);
 
-private:
-  const QRegExp omnis_dank_url_regex = QRegExp("\\b(https?://\\S+\\.\\S+)\\b");
+  //every message is one block, the oldest ones are dropped past this
+  static const int block_limit = 1000;
 
+private:
+  void append_linked_text(QTextCursor &p_cursor, QString p_text, QTextCharFormat p_format);
   void auto_scroll(QTextCursor old_cursor, int scrollbar_value, bool is_scrolled_down);
 };
 
@@ -0,0 +1,275 @@
+#include "aotranscriptwriter.hpp"
+
+#include "aochatarchive.hpp"
+
+#include <QDir>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QRunnable>
+#include <QMutexLocker>
+#include <QtEndian>
+#include <QDebug>
+
+class AOTranscriptWriteTask : public QRunnable
+{
+public:
+  AOTranscriptWriteTask(AOTranscriptWriter *p_writer) : m_writer(p_writer) {}
+
+  void run() { m_writer->write_pending(); }
+
+private:
+  AOTranscriptWriter *m_writer;
+};
+
+static quint32 gzip_crc32(const QByteArray &p_data)
+{
+  static quint32 f_table[256];
+  static bool f_table_ready = false;
+
+  if (!f_table_ready)
+  {
+    for (quint32 n_byte = 0 ; n_byte < 256 ; ++n_byte)
+    {
+      quint32 f_crc = n_byte;
+      for (int n_bit = 0 ; n_bit < 8 ; ++n_bit)
+        f_crc = (f_crc & 1) ? 0xEDB88320u ^ (f_crc >> 1) : f_crc >> 1;
+      f_table[n_byte] = f_crc;
+    }
+    f_table_ready = true;
+  }
+
+  quint32 f_crc = 0xFFFFFFFFu;
+  for (char f_char : p_data)
+    f_crc = f_table[(f_crc ^ static_cast<quint8>(f_char)) & 0xFF] ^ (f_crc >> 8);
+
+  return f_crc ^ 0xFFFFFFFFu;
+}
+
+class AOTranscriptFinishTask : public QRunnable
+{
+public:
+  AOTranscriptFinishTask(QString p_path, bool p_compress) : m_path(p_path), m_compress(p_compress) {}
+
+  void run()
+  {
+    //searchable right away, /logsearch only looks at archives
+    AOChatArchive::import_text_log(m_path, AOChatArchive::get_archive_path(m_path));
+
+    if (m_compress)
+      compress();
+  }
+
+private:
+  QString m_path;
+  bool m_compress;
+
+  void compress()
+  {
+    QFile f_in(m_path);
+    if (!f_in.open(QIODevice::ReadOnly))
+      return;
+
+    QByteArray f_data = f_in.readAll();
+    f_in.close();
+
+    //qCompress gives a 4 byte size, then a zlib stream: 2 byte header, deflate data, 4 byte adler32.
+    //gzip wants the same deflate data between its own header and trailer
+    QByteArray f_zlib = qCompress(f_data, 9);
+    if (f_zlib.size() < 10)
+      return;
+
+    static const char f_header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 2, '\xff'};
+
+    QByteArray f_gzip(f_header, 10);
+    f_gzip.append(f_zlib.constData() + 6, f_zlib.size() - 10);
+
+    uchar f_trailer[8];
+    qToLittleEndian<quint32>(gzip_crc32(f_data), f_trailer);
+    qToLittleEndian<quint32>(static_cast<quint32>(f_data.size()), f_trailer + 4);
+    f_gzip.append(reinterpret_cast<const char*>(f_trailer), 8);
+
+    QSaveFile f_out(m_path + ".gz");
+    if (!f_out.open(QIODevice::WriteOnly))
+      return;
+
+    f_out.write(f_gzip);
+
+    //the original only goes once the .gz is safely there
+    if (f_out.commit())
+      QFile::remove(m_path);
+    else
+      qDebug() << "Couldn't write" << m_path + ".gz" << f_out.errorString();
+  }
+};
+
+AOTranscriptWriter::AOTranscriptWriter(QString p_directory, QObject *p_parent) : QObject(p_parent)
+{
+  m_directory = p_directory;
+
+  m_pool.setMaxThreadCount(1);
+  m_finish_pool.setMaxThreadCount(1);
+
+  m_flush_timer = new QTimer(this);
+  m_flush_timer->setSingleShot(true);
+  m_flush_timer->setInterval(1000);
+
+  connect(m_flush_timer, SIGNAL(timeout()), this, SLOT(on_flush_timeout()));
+}
+
+AOTranscriptWriter::~AOTranscriptWriter()
+{
+  flush();
+
+  bool f_compress;
+  {
+    QMutexLocker locker(&m_state_mutex);
+    f_compress = m_compress;
+  }
+
+  {
+    QMutexLocker locker(&m_io_mutex);
+    close_file(f_compress);
+  }
+
+  m_finish_pool.waitForDone();
+}
+
+void AOTranscriptWriter::append_line(QString p_line)
+{
+  bool f_full;
+
+  {
+    QMutexLocker locker(&m_state_mutex);
+
+    m_pending.append((p_line + "\r\n").toLocal8Bit());
+    f_full = m_pending.size() >= batch_size;
+  }
+
+  if (f_full)
+  {
+    m_flush_timer->stop();
+    m_pool.start(new AOTranscriptWriteTask(this));
+  }
+  else if (!m_flush_timer->isActive())
+    m_flush_timer->start();
+}
+
+void AOTranscriptWriter::start_new_file()
+{
+  {
+    QMutexLocker locker(&m_state_mutex);
+    m_new_file = true;
+  }
+
+  m_flush_timer->stop();
+  m_pool.start(new AOTranscriptWriteTask(this));
+}
+
+void AOTranscriptWriter::set_flush_interval(int p_msecs)
+{
+  m_flush_timer->setInterval(qMax(0, p_msecs));
+}
+
+void AOTranscriptWriter::set_max_size(qint64 p_bytes)
+{
+  QMutexLocker locker(&m_state_mutex);
+  m_max_size = p_bytes;
+}
+
+void AOTranscriptWriter::set_rotate_daily(bool p_enabled)
+{
+  QMutexLocker locker(&m_state_mutex);
+  m_rotate_daily = p_enabled;
+}
+
+void AOTranscriptWriter::set_compress(bool p_enabled)
+{
+  QMutexLocker locker(&m_state_mutex);
+  m_compress = p_enabled;
+}
+
+void AOTranscriptWriter::flush()
+{
+  m_flush_timer->stop();
+
+  //let a write that is already running finish first, then do the rest ourselves
+  m_pool.waitForDone();
+  write_pending();
+}
+
+void AOTranscriptWriter::on_flush_timeout()
+{
+  m_pool.start(new AOTranscriptWriteTask(this));
+}
+
+void AOTranscriptWriter::write_pending()
+{
+  QMutexLocker io_locker(&m_io_mutex);
+
+  QByteArray f_batch;
+  bool f_new_file;
+  qint64 f_max_size;
+  bool f_rotate_daily;
+  bool f_compress;
+
+  {
+    QMutexLocker state_locker(&m_state_mutex);
+    f_batch.swap(m_pending);
+    f_new_file = m_new_file;
+    m_new_file = false;
+    f_max_size = m_max_size;
+    f_rotate_daily = m_rotate_daily;
+    f_compress = m_compress;
+  }
+
+  if (!f_batch.isEmpty())
+  {
+    if (m_file.isOpen())
+    {
+      bool f_new_day = f_rotate_daily && QDate::currentDate() != m_file_date;
+      bool f_too_big = f_max_size > 0 && m_file.size() > 0 && m_file.size() + f_batch.size() > f_max_size;
+
+      if (f_new_day || f_too_big)
+        close_file(f_compress);
+    }
+
+    if (m_file.isOpen() || open_file())
+    {
+      m_file.write(f_batch);
+      //hands it to the OS, a crash of ours can't lose it anymore
+      m_file.flush();
+    }
+  }
+
+  //whatever was queued before the request still belongs to the old file
+  if (f_new_file)
+    close_file(f_compress);
+}
+
+bool AOTranscriptWriter::open_file()
+{
+  QDir().mkpath(m_directory);
+
+  QString f_path = m_directory + QDateTime::currentDateTime().toString("ddd MMMM yyyy hh.mm.ss.z") + ".txt";
+
+  m_file.setFileName(f_path);
+  if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append))
+  {
+    qDebug() << "Couldn't open" << f_path << m_file.errorString();
+    return false;
+  }
+
+  m_file_date = QDate::currentDate();
+  return true;
+}
+
+void AOTranscriptWriter::close_file(bool p_compress)
+{
+  if (!m_file.isOpen())
+    return;
+
+  QString f_path = m_file.fileName();
+  m_file.close();
+
+  m_finish_pool.start(new AOTranscriptFinishTask(f_path, p_compress));
+}
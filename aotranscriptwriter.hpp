@@ -0,0 +1,84 @@
+#ifndef AOTRANSCRIPTWRITER_HPP
+#define AOTRANSCRIPTWRITER_HPP
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QDate>
+#include <QMutex>
+#include <QThreadPool>
+#include <QTimer>
+
+class AOTranscriptWriteTask;
+
+/**
+ * @brief The AOTranscriptWriter keeps the IC log on disk.
+ * Lines are queued on the GUI thread and written in batches by a background thread
+ * that keeps the file open the whole time. A new file is started every day or once the
+ * current one is too big. Finished files are archived for /logsearch and can be gzipped,
+ * both in the background.
+ */
+
+class AOTranscriptWriter : public QObject
+{
+  Q_OBJECT
+
+public:
+  AOTranscriptWriter(QString p_directory, QObject *p_parent = nullptr);
+  ~AOTranscriptWriter();
+
+  //Queues p_line for the current transcript, the file is opened on the first line
+  void append_line(QString p_line);
+
+  //Lines after this go into a new file
+  void start_new_file();
+
+  //How long a line may wait before it's written
+  void set_flush_interval(int p_msecs);
+  //0 means no limit
+  void set_max_size(qint64 p_bytes);
+  void set_rotate_daily(bool p_enabled);
+  //Finished files are replaced by a .gz of themselves
+  void set_compress(bool p_enabled);
+
+  //Writes everything that is queued right away on the calling thread
+  void flush();
+
+private:
+  //written as soon as this much is queued, timer or not
+  const int batch_size = 64 * 1024;
+
+  QString m_directory;
+
+  //guards m_pending, m_new_file and the settings
+  QMutex m_state_mutex;
+  QByteArray m_pending;
+  bool m_new_file = false;
+  qint64 m_max_size = 0;
+  bool m_rotate_daily = true;
+  bool m_compress = false;
+
+  //held for the whole write, only the thread holding it touches m_file
+  QMutex m_io_mutex;
+  QFile m_file;
+  QDate m_file_date;
+
+  QTimer *m_flush_timer;
+
+  //a single thread, so batches hit the file in order
+  QThreadPool m_pool;
+  //archiving and compressing finished files, on a thread of its own so a big file never holds up the log
+  QThreadPool m_finish_pool;
+
+  void write_pending();
+  bool open_file();
+  void close_file(bool p_compress);
+
+  friend class AOTranscriptWriteTask;
+
+private slots:
+  void on_flush_timeout();
+};
+
+#endif // AOTRANSCRIPTWRITER_HPP
@@ -0,0 +1,288 @@
+#include "aoviewport.hpp"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QStyle>
+#include <QVariant>
+#include <QDebug>
+
+AOViewport::AOViewport(QWidget *p_parent) : QWidget(p_parent)
+{
+}
+
+AOViewport::~AOViewport()
+{
+  //the layers inside are only deleted after us, and the ones outside may outlive us
+  for (const layer &f_layer : m_layers)
+  {
+    if (f_layer.label.isNull())
+      continue;
+
+    f_layer.label->setProperty("ao_viewport", QVariant());
+    f_layer.label->removeEventFilter(this);
+  }
+}
+
+void AOViewport::add_layer(QLabel *p_layer)
+{
+  layer f_layer;
+  f_layer.label = p_layer;
+  m_layers.append(f_layer);
+
+  //lets set_pixmap find us, even while the layer lives outside
+  p_layer->setProperty("ao_viewport", QVariant::fromValue(static_cast<QObject*>(this)));
+  p_layer->installEventFilter(this);
+
+  restack();
+}
+
+void AOViewport::place_layer(QLabel *p_layer, QRect p_rect)
+{
+  int n_layer = find_layer(p_layer);
+  if (n_layer < 0)
+    return;
+
+  layer &f_layer = m_layers[n_layer];
+  bool is_inside = geometry().contains(p_rect);
+
+  if (is_inside != f_layer.is_inside)
+  {
+    //reparenting hides a widget
+    bool was_hidden = p_layer->isHidden();
+
+    p_layer->setParent(is_inside ? this : parentWidget());
+    f_layer.is_inside = is_inside;
+
+    //outside, the label paints the pixmap itself like any other
+    if (is_inside)
+      p_layer->clear();
+    else
+      p_layer->setPixmap(f_layer.pixmap);
+
+    p_layer->setVisible(!was_hidden);
+    restack();
+  }
+
+  if (is_inside)
+    p_rect.translate(-pos());
+
+  p_layer->move(p_rect.topLeft());
+  p_layer->resize(p_rect.size());
+}
+
+void AOViewport::set_pixmap(QLabel *p_label, QPixmap p_pixmap, QRect p_opaque)
+{
+  AOViewport *f_viewport = qobject_cast<AOViewport*>(p_label->property("ao_viewport").value<QObject*>());
+  int n_layer = f_viewport != nullptr ? f_viewport->find_layer(p_label) : -1;
+
+  if (n_layer < 0)
+  {
+    p_label->setPixmap(p_pixmap);
+    return;
+  }
+
+  f_viewport->set_layer_pixmap(n_layer, p_pixmap, p_opaque);
+}
+
+void AOViewport::clear_pixmap(QLabel *p_label)
+{
+  AOViewport *f_viewport = qobject_cast<AOViewport*>(p_label->property("ao_viewport").value<QObject*>());
+  int n_layer = f_viewport != nullptr ? f_viewport->find_layer(p_label) : -1;
+
+  if (n_layer < 0)
+  {
+    p_label->clear();
+    return;
+  }
+
+  f_viewport->set_layer_pixmap(n_layer, QPixmap(), QRect());
+}
+
+int AOViewport::find_layer(QObject *p_label)
+{
+  for (int n_layer = 0 ; n_layer < m_layers.size() ; ++n_layer)
+  {
+    if (m_layers.at(n_layer).label.data() == p_label)
+      return n_layer;
+  }
+
+  return -1;
+}
+
+void AOViewport::set_layer_pixmap(int n_layer, QPixmap p_pixmap, QRect p_opaque)
+{
+  layer &f_layer = m_layers[n_layer];
+
+  if (!f_layer.is_inside)
+  {
+    f_layer.pixmap = p_pixmap;
+    f_layer.opaque = p_opaque;
+
+    if (p_pixmap.isNull())
+      f_layer.label->clear();
+    else
+      f_layer.label->setPixmap(p_pixmap);
+    return;
+  }
+
+  //a hidden layer is repainted by Qt once it's shown again
+  bool is_shown = !f_layer.label->isHidden();
+
+  QRegion f_dirty;
+  if (is_shown)
+    f_dirty += get_drawn_rect(f_layer);
+
+  f_layer.pixmap = p_pixmap;
+  f_layer.opaque = p_opaque;
+
+  if (is_shown)
+    f_dirty += get_drawn_rect(f_layer);
+
+  if (!f_dirty.isEmpty())
+    update(f_dirty);
+}
+
+void AOViewport::restack()
+{
+  for (const layer &f_layer : m_layers)
+  {
+    if (f_layer.is_inside && !f_layer.label.isNull())
+      f_layer.label->raise();
+  }
+
+  if (parentWidget() == nullptr)
+    return;
+
+  //right above the viewport, under whatever the parent put on top of it
+  QWidget *f_above = nullptr;
+  bool is_past_viewport = false;
+
+  for (QObject *f_child : parentWidget()->children())
+  {
+    if (f_child == this)
+      is_past_viewport = true;
+    else if (is_past_viewport && f_child->isWidgetType() && find_layer(f_child) < 0)
+    {
+      f_above = static_cast<QWidget*>(f_child);
+      break;
+    }
+  }
+
+  for (const layer &f_layer : m_layers)
+  {
+    if (f_layer.is_inside || f_layer.label.isNull())
+      continue;
+
+    if (f_above != nullptr)
+      f_layer.label->stackUnder(f_above);
+    else
+      f_layer.label->raise();
+  }
+}
+
+bool AOViewport::eventFilter(QObject *watched, QEvent *event)
+{
+  //the layers inside have nothing to paint, we drew their pixmaps underneath them
+  if (event->type() == QEvent::Paint)
+  {
+    int n_layer = find_layer(watched);
+
+    if (n_layer >= 0 && m_layers.at(n_layer).is_inside)
+      return true;
+  }
+
+  return QWidget::eventFilter(watched, event);
+}
+
+void AOViewport::paintEvent(QPaintEvent *event)
+{
+  QElapsedTimer f_timer;
+  if (m_log_stats)
+    f_timer.start();
+
+  QPainter f_painter(this);
+
+  for (const layer &f_layer : m_layers)
+  {
+    if (!f_layer.is_inside || f_layer.label.isNull() || f_layer.label->isHidden() || f_layer.pixmap.isNull())
+      continue;
+
+    draw_layer(f_painter, f_layer, event->region());
+  }
+
+  if (!m_log_stats)
+    return;
+
+  m_paint_nsecs += f_timer.nsecsElapsed();
+  ++m_paint_count;
+
+  for (const QRect &f_rect : event->region().rects())
+    m_paint_pixels += qint64(f_rect.width()) * f_rect.height();
+
+  if (!m_stats_period.isValid())
+    m_stats_period.start();
+  else if (m_stats_period.elapsed() >= 1000)
+  {
+    qDebug() << "viewport:" << m_paint_count << "paints," << m_paint_pixels << "pixels,"
+             << m_paint_nsecs / 1000 << "us of painting in" << m_stats_period.elapsed() << "ms";
+
+    m_paint_nsecs = 0;
+    m_paint_pixels = 0;
+    m_paint_count = 0;
+    m_stats_period.restart();
+  }
+}
+
+QRect AOViewport::get_target(const layer &p_layer)
+{
+  QLabel *f_label = p_layer.label;
+
+  //places the pixmap exactly where the label would have put it
+  QRect f_target;
+
+  if (f_label->hasScaledContents())
+    f_target = f_label->contentsRect();
+  else
+  {
+    Qt::Alignment f_alignment = QStyle::visualAlignment(f_label->layoutDirection(), f_label->alignment());
+    QSize f_size = p_layer.pixmap.size() / p_layer.pixmap.devicePixelRatio();
+    f_target = QStyle::alignedRect(f_label->layoutDirection(), f_alignment, f_size, f_label->contentsRect());
+  }
+
+  return f_target.translated(f_label->pos());
+}
+
+QRect AOViewport::get_drawn_rect(const layer &p_layer)
+{
+  if (p_layer.pixmap.isNull() || p_layer.opaque.isEmpty())
+    return QRect();
+
+  QRect f_target = get_target(p_layer);
+  qreal f_scale_x = qreal(f_target.width()) / p_layer.pixmap.width();
+  qreal f_scale_y = qreal(f_target.height()) / p_layer.pixmap.height();
+
+  QRectF f_opaque(f_target.x() + p_layer.opaque.x() * f_scale_x, f_target.y() + p_layer.opaque.y() * f_scale_y,
+                  p_layer.opaque.width() * f_scale_x, p_layer.opaque.height() * f_scale_y);
+
+  //a label never paints outside itself
+  return f_opaque.toAlignedRect() & f_target & p_layer.label->geometry();
+}
+
+void AOViewport::draw_layer(QPainter &p_painter, const layer &p_layer, const QRegion &p_region)
+{
+  QRegion f_dirty = p_region & get_drawn_rect(p_layer);
+  if (f_dirty.isEmpty())
+    return;
+
+  QRect f_target = get_target(p_layer);
+  qreal f_scale_x = qreal(p_layer.pixmap.width()) / f_target.width();
+  qreal f_scale_y = qreal(p_layer.pixmap.height()) / f_target.height();
+
+  //only the dirty parts get blended, not the whole layer
+  for (const QRect &f_rect : f_dirty.rects())
+  {
+    QRectF f_source((f_rect.x() - f_target.x()) * f_scale_x, (f_rect.y() - f_target.y()) * f_scale_y,
+                    f_rect.width() * f_scale_x, f_rect.height() * f_scale_y);
+    p_painter.drawPixmap(QRectF(f_rect), p_layer.pixmap, f_source);
+  }
+}
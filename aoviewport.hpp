@@ -0,0 +1,80 @@
+#ifndef AOVIEWPORT_HPP
+#define AOVIEWPORT_HPP
+
+#include <QWidget>
+#include <QLabel>
+#include <QPixmap>
+#include <QRect>
+#include <QRegion>
+#include <QVector>
+#include <QPointer>
+#include <QElapsedTimer>
+
+/**
+ * @brief The AOViewport owns the courtroom's layers and composites them in a single paint pass.
+ * Layers stay QLabel-based widgets, so they are still moved, resized, shown and hidden like any
+ * other widget, but they hand their pixmaps to the viewport instead of painting them. When a
+ * layer gets a new pixmap only the parts of the old and the new one that aren't transparent are
+ * marked dirty, and a repaint only blends the layers that overlap the dirty region, clipped to it.
+ */
+
+class AOViewport : public QWidget
+{
+  Q_OBJECT
+
+public:
+  AOViewport(QWidget *p_parent);
+  ~AOViewport();
+
+  //Takes p_layer over, on top of the layers added before it. p_layer has to be a child of the viewport
+  void add_layer(QLabel *p_layer);
+
+  //Puts p_layer at p_rect, given in the coordinates of the viewport's parent. A layer that doesn't
+  //fit inside the viewport is handed to the parent and paints itself there, above the viewport
+  void place_layer(QLabel *p_layer, QRect p_rect);
+
+  //Shows p_pixmap on p_label. Layers of a viewport hand it to their viewport, any other label just
+  //gets it. p_opaque is the part of p_pixmap that isn't fully transparent, empty if none of it is
+  static void set_pixmap(QLabel *p_label, QPixmap p_pixmap, QRect p_opaque);
+  static void set_pixmap(QLabel *p_label, QPixmap p_pixmap) {set_pixmap(p_label, p_pixmap, p_pixmap.rect());}
+  static void clear_pixmap(QLabel *p_label);
+
+  //logs how much time painting takes and how many pixels get blended, once a second
+  void set_log_stats(bool p_log_stats) {m_log_stats = p_log_stats;}
+
+protected:
+  void paintEvent(QPaintEvent *event) override;
+  bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+  struct layer
+  {
+    QPointer<QLabel> label;
+    QPixmap pixmap;
+    //in pixmap coordinates
+    QRect opaque;
+    //false while it lives in the viewport's parent, see place_layer()
+    bool is_inside = true;
+  };
+
+  QVector<layer> m_layers;
+
+  bool m_log_stats = false;
+  QElapsedTimer m_stats_period;
+  qint64 m_paint_nsecs = 0;
+  qint64 m_paint_pixels = 0;
+  int m_paint_count = 0;
+
+  int find_layer(QObject *p_label);
+  void set_layer_pixmap(int n_layer, QPixmap p_pixmap, QRect p_opaque);
+  //puts the layers back in the order they were added, inside and outside the viewport
+  void restack();
+
+  //where the pixmap of p_layer ends up, in viewport coordinates
+  static QRect get_target(const layer &p_layer);
+  //the part of get_target() that isn't transparent and that the label doesn't clip away
+  static QRect get_drawn_rect(const layer &p_layer);
+  void draw_layer(QPainter &p_painter, const layer &p_layer, const QRegion &p_region);
+};
+
+#endif // AOVIEWPORT_HPP
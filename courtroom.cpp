@@ -24,28 +24,29 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
 {
   ao_app = p_ao_app;
 
-  //initializing sound device
-  BASS_Init(-1, 48000, BASS_DEVICE_LATENCY, 0, NULL);
-  BASS_PluginLoad("bassopus.dll", BASS_UNICODE);
-
   keepalive_timer = new QTimer(this);
   keepalive_timer->start(60000);
 
-  chat_tick_timer = new QTimer(this);
+  //everything that animates goes through the frame clock, so it all wakes up together
+  chat_tick_timer = new AOClockTimer(ao_app->frame_clock, this);
+
+  note_save_timer = new QTimer(this);
+  note_save_timer->setSingleShot(true);
+  note_save_timer->setInterval(note_save_delay);
 
-  text_delay_timer = new QTimer(this);
+  text_delay_timer = new AOClockTimer(ao_app->frame_clock, this);
   text_delay_timer->setSingleShot(true);
 
-  sfx_delay_timer = new QTimer(this);
+  sfx_delay_timer = new AOClockTimer(ao_app->frame_clock, this);
   sfx_delay_timer->setSingleShot(true);
 
-  realization_timer = new QTimer(this);
+  realization_timer = new AOClockTimer(ao_app->frame_clock, this);
   realization_timer->setSingleShot(true);
 
-  testimony_show_timer = new QTimer(this);
+  testimony_show_timer = new AOClockTimer(ao_app->frame_clock, this);
   testimony_show_timer->setSingleShot(true);
 
-  testimony_hide_timer = new QTimer(this);
+  testimony_hide_timer = new AOClockTimer(ao_app->frame_clock, this);
   testimony_hide_timer->setSingleShot(true);
 
   char_button_mapper = new QSignalMapper(this);
@@ -65,7 +66,12 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
 
   ui_background = new AOImage(this, ao_app);
 
-  ui_viewport = new QWidget(this);
+  scene_cache = new AOSceneCache(ao_app, this);
+  connect(ao_app->asset_index, SIGNAL(index_changed(QStringList)), scene_cache, SLOT(on_index_changed(QStringList)));
+  connect(scene_cache, SIGNAL(legacy_desk_finished()), this, SLOT(on_legacy_desk_finished()));
+
+  ui_viewport = new AOViewport(this);
+  ui_viewport->set_log_stats(ao_app->read_config("viewport_stats") == "true");
   ui_vp_background = new AOScene(ui_viewport, ao_app);
   ui_vp_speedlines = new AOMovie(ui_viewport, ao_app);
   ui_vp_speedlines->set_play_once(false);
@@ -73,6 +79,13 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
   ui_vp_desk = new AOScene(ui_viewport, ao_app);
   ui_vp_legacy_desk = new AOScene(ui_viewport, ao_app);
 
+  //same order as they are stacked
+  ui_viewport->add_layer(ui_vp_background);
+  ui_viewport->add_layer(ui_vp_speedlines);
+  ui_viewport->add_layer(ui_vp_player_char);
+  ui_viewport->add_layer(ui_vp_desk);
+  ui_viewport->add_layer(ui_vp_legacy_desk);
+
   ui_vp_music_display_a = new AOImage(this, ao_app);
   ui_vp_music_display_b = new AOImage(this, ao_app);
   ui_vp_music_area = new QWidget(ui_vp_music_display_a);
@@ -84,25 +97,29 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
   ui_vp_music_name->setReadOnly(true);
   music_anim = new QPropertyAnimation(ui_vp_music_name, "geometry", this);
 
-  ui_vp_evidence_display = new AOEvidenceDisplay(this, ao_app);
+  ui_vp_evidence_display = new AOEvidenceDisplay(ui_viewport, ao_app);
 
-  ui_vp_chatbox = new AOImage(this, ao_app);
+  ui_vp_chatbox = new AOImage(ui_viewport, ao_app);
   ui_vp_showname = new QLabel(ui_vp_chatbox);
-  ui_vp_message = new QTextEdit(ui_vp_chatbox);
-  ui_vp_message->setFrameStyle(QFrame::NoFrame);
-  ui_vp_message->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-  ui_vp_message->setVerticalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
-  ui_vp_message->setReadOnly(true);
+  ui_vp_message = new AOMessageDisplay(ui_vp_chatbox);
 
-  ui_vp_showname_image = new AOImage(this, ao_app);
+  ui_vp_showname_image = new AOImage(ui_viewport, ao_app);
 
-  ui_vp_testimony = new AOImage(this, ao_app);
-  ui_vp_effect = new AOMovie(this, ao_app);
-  ui_vp_wtce = new AOMovie(this, ao_app);
-  ui_vp_objection = new AOMovie(this, ao_app);
+  ui_vp_testimony = new AOImage(ui_viewport, ao_app);
+  ui_vp_effect = new AOMovie(ui_viewport, ao_app);
+  ui_vp_wtce = new AOMovie(ui_viewport, ao_app);
+  ui_vp_objection = new AOMovie(ui_viewport, ao_app);
 
-  ui_ic_chatlog = new QTextEdit(this);
-  ui_ic_chatlog->setReadOnly(true);
+  //the text on the chatbox and the evidence icon are their own widgets and paint themselves on top
+  ui_viewport->add_layer(ui_vp_evidence_display);
+  ui_viewport->add_layer(ui_vp_chatbox);
+  ui_viewport->add_layer(ui_vp_showname_image);
+  ui_viewport->add_layer(ui_vp_testimony);
+  ui_viewport->add_layer(ui_vp_effect);
+  ui_viewport->add_layer(ui_vp_wtce);
+  ui_viewport->add_layer(ui_vp_objection);
+
+  ui_ic_chatlog = new AOICLog(this);
 
   ui_ms_chatlog = new AOTextArea(this);
   ui_ms_chatlog->setReadOnly(true);
@@ -275,7 +292,7 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
   ui_evidence_button = new AOButton(this, ao_app);
 
   ui_vp_notepad_image = new AOImage(this, ao_app);
-  ui_vp_notepad = new QTextEdit(this);
+  ui_vp_notepad = new AONotepad(this, ao_app);
   ui_vp_notepad->setFrameStyle(QFrame::NoFrame);
 
   construct_evidence();
@@ -311,6 +328,7 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
 
   connect(ui_music_list, SIGNAL(clicked(QModelIndex)), this, SLOT(on_music_list_clicked()));
   connect(ui_music_list, SIGNAL(doubleClicked(QModelIndex)), this, SLOT(on_music_list_double_clicked(QModelIndex)));
+  connect(ui_music_list, SIGNAL(currentRowChanged(int)), this, SLOT(on_music_list_highlighted(int)));
 
   for(auto & shout : ui_shouts)
     connect(shout, SIGNAL(clicked(bool)), this, SLOT(on_shout_clicked()));
@@ -355,6 +373,8 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
   connect(ui_note_button, SIGNAL(clicked()), this, SLOT(on_note_button_clicked()));
 
   connect(ui_vp_notepad, SIGNAL(textChanged()), this, SLOT(on_note_text_changed()));
+  connect(ui_vp_notepad, SIGNAL(focus_lost()), this, SLOT(on_note_focus_lost()));
+  connect(note_save_timer, SIGNAL(timeout()), this, SLOT(autosave_note()));
 
   connect(ui_pre, SIGNAL(clicked()), this, SLOT(on_pre_clicked()));
   connect(ui_flip, SIGNAL(clicked()), this, SLOT(on_flip_clicked()));
@@ -373,6 +393,17 @@ Courtroom::Courtroom(AOApplication *p_ao_app) : QMainWindow()
   set_char_select();
 }
 
+Courtroom::~Courtroom()
+{
+  //don't lose whatever was typed in the last few hundred milliseconds
+  if (note_dirty)
+    save_note();
+
+  ao_app->file_writer->flush();
+  //the next courtroom gets a log of its own, like it always did
+  ao_app->transcript_writer->start_new_file();
+}
+
 void Courtroom::set_mute_list()
 {
   mute_map.clear();
@@ -462,27 +493,26 @@ void Courtroom::set_widgets()
 
   set_size_and_pos(ui_vp_showname, "showname");
 
-  set_size_and_pos(ui_vp_showname_image, "showname_image");
+  set_layer_size_and_pos(ui_vp_showname_image, "showname_image");
   ui_vp_showname_image->hide();
 
   set_size_and_pos(ui_vp_message, "message");
-  ui_vp_message->setTextInteractionFlags(Qt::NoTextInteraction);
   ui_vp_message->setStyleSheet("background-color: rgba(0, 0, 0, 0);"
                                "color: white");
 
-  ui_vp_testimony->move(ui_viewport->x(), ui_viewport->y());
+  ui_vp_testimony->move(0, 0);
   ui_vp_testimony->resize(ui_viewport->width(), ui_viewport->height());
   ui_vp_testimony->set_image("testimony.png");
   ui_vp_testimony->hide();
 
-  ui_vp_effect->move(ui_viewport->x(), ui_viewport->y());
+  ui_vp_effect->move(0, 0);
   ui_vp_effect->resize(ui_viewport->width(), ui_viewport->height());
   ui_vp_effect->hide();
 
-  ui_vp_wtce->move(ui_viewport->x(), ui_viewport->y());
+  ui_vp_wtce->move(0, 0);
   ui_vp_wtce->combo_resize(ui_viewport->width(), ui_viewport->height());
 
-  ui_vp_objection->move(ui_viewport->x(), ui_viewport->y());
+  ui_vp_objection->move(0, 0);
   ui_vp_objection->combo_resize(ui_viewport->width(), ui_viewport->height());
 
   set_size_and_pos(ui_ic_chatlog, "ic_chatlog");
@@ -504,12 +534,12 @@ void Courtroom::set_widgets()
   if (is_ao2_bg)
   {
     set_size_and_pos(ui_ic_chat_message, "ao2_ic_chat_message");
-    set_size_and_pos(ui_vp_chatbox, "ao2_chatbox");
+    set_layer_size_and_pos(ui_vp_chatbox, "ao2_chatbox");
   }
   else
   {
     set_size_and_pos(ui_ic_chat_message, "ic_chat_message");
-    set_size_and_pos(ui_vp_chatbox, "chatbox");
+    set_layer_size_and_pos(ui_vp_chatbox, "chatbox");
   }
 
   set_size_and_pos(ui_vp_music_area, "music_area");
@@ -994,28 +1024,6 @@ void Courtroom::set_window_title(QString p_title)
   this->setWindowTitle(p_title);
 }
 
-void Courtroom::set_char_rpc()
-{
-  rpc_char_list.clear();
-
-  QFile config_file(ao_app->get_base_path() + rpc_ini);
-  if (!config_file.open(QIODevice::ReadOnly))
-  { qDebug() << "Error reading" << ao_app->get_base_path() + rpc_ini; return; }
-
-  QTextStream in(&config_file);
-
-  while(!in.atEnd())
-  {
-    QString f_line = in.readLine().trimmed();
-
-    QStringList line_elements = f_line.split("-");
-
-    rpc_char_list.append(line_elements.at(1).trimmed().toLower());
-  }
-
-  config_file.close();
-}
-
 void Courtroom::set_size_and_pos(QWidget *p_widget, QString p_identifier)
 {
   QString filename = design_ini;
@@ -1035,6 +1043,20 @@ void Courtroom::set_size_and_pos(QWidget *p_widget, QString p_identifier)
   }
 }
 
+void Courtroom::set_layer_size_and_pos(QLabel *p_layer, QString p_identifier)
+{
+  pos_size_type design_ini_result = ao_app->get_element_dimensions(p_identifier, design_ini);
+
+  if (design_ini_result.width < 0 || design_ini_result.height < 0)
+  {
+    qDebug() << "W: could not find \"" << p_identifier << "\" in " << design_ini;
+    p_layer->hide();
+  }
+  else
+    ui_viewport->place_layer(p_layer, QRect(design_ini_result.x, design_ini_result.y,
+                                            design_ini_result.width, design_ini_result.height));
+}
+
 void Courtroom::set_taken(int n_char, bool p_taken)
 {
   if (n_char >= char_list.size())
@@ -1086,14 +1108,17 @@ void Courtroom::set_background(QString p_background)
 
   if (is_ao2_bg)
   {
-    set_size_and_pos(ui_vp_chatbox, "ao2_chatbox");
+    set_layer_size_and_pos(ui_vp_chatbox, "ao2_chatbox");
     set_size_and_pos(ui_ic_chat_message, "ao2_ic_chat_message");
   }
   else
   {
-    set_size_and_pos(ui_vp_chatbox, "chatbox");
+    set_layer_size_and_pos(ui_vp_chatbox, "chatbox");
     set_size_and_pos(ui_ic_chat_message, "ic_chat_message");
   }
+
+  //gets every side ready before the first message switches to one
+  scene_cache->load(bg_path, is_ao2_bg, ui_viewport->size());
 }
 
 void Courtroom::enter_courtroom(int p_cid)
@@ -1102,7 +1127,9 @@ void Courtroom::enter_courtroom(int p_cid)
 
   QString f_char;
 
-  set_char_rpc();
+  //picks up edits to char.ini shownames and character files made while we were away
+  ao_app->name_resolver->invalidate();
+  ao_app->asset_resolver->invalidate();
 
   if (m_cid == -1)
   {
@@ -1116,7 +1143,7 @@ void Courtroom::enter_courtroom(int p_cid)
     QRegularExpression re(QString::fromUtf8("[-`~!@#$%^&*()—+=|:;<>«»,.?/{}\'\"\\[\\]]")); // regex for removing non letter (except _) characters
     r_char.remove(re);
 
-    if(!rpc_char_list.contains(f_char.toLower()))
+    if(!ao_app->name_resolver->is_rpc_char(f_char))
     {
       ao_app->discord->toggle(1);
     }
@@ -1150,10 +1177,18 @@ void Courtroom::enter_courtroom(int p_cid)
     m_log_limit = log_limit;
 
   m_scroll_down = ao_app->read_config("scroll_type") == "down";
-  if(m_previously_scroll_down != m_scroll_down)
-    m_scroll_type_changed = !m_scroll_type_changed;
 
-  m_previously_scroll_down = m_scroll_down;
+  ui_ic_chatlog->set_capacity(m_log_limit);
+  ui_ic_chatlog->set_newest_on_top(!m_scroll_down);
+
+  //0 or missing keeps the defaults
+  if (const int flush_interval = ao_app->read_config("log_flush_interval").toInt())
+    ao_app->transcript_writer->set_flush_interval(flush_interval);
+  ao_app->transcript_writer->set_max_size(ao_app->read_config("log_max_size").toLongLong() * 1024);
+  ao_app->transcript_writer->set_rotate_daily(ao_app->read_config("log_rotate_daily") != "false");
+  ao_app->transcript_writer->set_compress(ao_app->read_config("log_compress") == "true");
+
+  m_log_ic_stats = ao_app->read_config("ic_stats") == "true";
 
   set_evidence_page();
 
@@ -1339,16 +1374,25 @@ void Courtroom::list_sfx()
 void Courtroom::list_note_files()
 {
   QString f_config = ao_app->get_base_path() + file_select_ini;
-  QFile f_file(f_config);
-  if(!f_file.open(QIODevice::ReadOnly))
-  { qDebug() << "Couldn't open" << f_config; return; }
+
+  //a rewrite of the file may still be queued, that one is newer than the disk
+  QByteArray f_contents;
+  if(!ao_app->file_writer->get_pending_contents(f_config, f_contents))
+  {
+    QFile f_file(f_config);
+    if(!f_file.open(QIODevice::ReadOnly))
+    { qDebug() << "Couldn't open" << f_config; return; }
+
+    f_contents = f_file.readAll();
+    f_file.close();
+  }
 
   note_list.clear();
 
   QString f_filestring = "";
   QString f_filename = "";
 
-  QTextStream in(&f_file);
+  QTextStream in(&f_contents, QIODevice::ReadOnly);
 
   QVBoxLayout *f_layout = ui_note_area->m_layout;
 
@@ -1379,10 +1423,21 @@ void Courtroom::load_note()
 {
   QString f_text = ao_app->read_note(current_file);
   ui_vp_notepad->setText(f_text);
+
+  //the text we just loaded is already on the disk
+  note_save_timer->stop();
+  note_dirty = false;
 }
 
 void Courtroom::save_note()
 {
+  note_save_timer->stop();
+  note_dirty = false;
+
+  if (current_file == "")
+    return;
+
+  //the snapshot is taken once per pause in typing instead of once per keystroke
   QString f_text = ui_vp_notepad->toPlainText();
 
   ao_app->write_note(f_text, current_file);
@@ -1390,9 +1445,8 @@ void Courtroom::save_note()
 
 void Courtroom::save_textlog(QString p_text)
 {
-  QString f_file = ao_app->get_base_path() + icchatlogsfilename;
-
-  ao_app->append_note(p_text, f_file);
+  //queued, the writer thread batches it to the disk
+  ao_app->transcript_writer->append_line(p_text);
 }
 
 void Courtroom::list_themes()
@@ -1624,18 +1678,22 @@ void Courtroom::handle_chatmessage(QStringList *p_contents)
   if (mute_map.value(m_chatmessage[CHAR_ID].toInt()))
     return;
 
-  QString f_showname = ao_app->get_showname(char_list.at(f_char_id).name);
+  QString f_showname = ao_app->name_resolver->get_showname(char_list.at(f_char_id).name);
 
   QString f_message = f_showname + ": " + m_chatmessage[MESSAGE] + '\n';
 
   if (f_message == previous_ic_message)
     return;
 
+  if (m_log_ic_stats)
+    log_ic_stats();
+
   text_state = 0;
   anim_state = 0;
   ui_vp_objection->stop();
   ui_vp_player_char->stop();
   chat_tick_timer->stop();
+  m_blip_player->stop();
   ui_vp_evidence_display->reset();
 
   // reset effect
@@ -1702,7 +1760,7 @@ void Courtroom::handle_chatmessage_2()
 
   QString real_name = char_list.at(m_chatmessage[CHAR_ID].toInt()).name;
 
-  QString f_showname = ao_app->get_showname(real_name);
+  QString f_showname = ao_app->name_resolver->get_showname(real_name);
   QString f_color = ao_app->read_char_ini(real_name, "color", "[Options]", "[Time]");
   if (f_color == "")
     f_color = "rgb(" + ao_app->read_design_ini("showname_color" , ao_app->get_theme_path() + "courtroom_fonts.ini") + ")";
@@ -1838,7 +1896,7 @@ void Courtroom::handle_chatmessage_3()
   QString effect = m_chatmessage[EFFECT_STATE];
   QStringList offset = ao_app->get_effect_offset(f_char, effect.toInt());
 
-  ui_vp_effect->move(ui_viewport->x() + offset.at(0).toInt(), ui_viewport->y() + offset.at(1).toInt());
+  ui_vp_effect->move(offset.at(0).toInt(), offset.at(1).toInt());
 
   QStringList overlay = ao_app->get_overlay(f_char, effect.toInt());
   QString overlay_name = overlay.at(0);
@@ -1891,75 +1949,50 @@ void Courtroom::handle_chatmessage_3()
       break;
     }
   }
-
 }
 
-void Courtroom::append_ic_text(QString p_text, QString p_name)
+void Courtroom::log_ic_stats()
 {
-  QTextCharFormat bold;
-  QTextCharFormat normal;
-  bold.setFontWeight(QFont::Bold);
-  normal.setFontWeight(QFont::Normal);
-  const QTextCursor old_cursor = ui_ic_chatlog->textCursor();
-  const int old_scrollbar_value = ui_ic_chatlog->verticalScrollBar()->value();
-  const bool is_scrolled_up = old_scrollbar_value == ui_ic_chatlog->verticalScrollBar()->maximum();
-  const QTextCursor::MoveOperation f_operation = m_scroll_down ? QTextCursor::End : QTextCursor::Start;
+  int f_index_hits = ao_app->asset_index->get_hit_count();
+  int f_disk_checks = get_disk_check_count();
 
-  //rewrite everything that was written before
-  if(m_scroll_type_changed)
+  //the message before this one is over now, whatever its timers and early returns looked up
+  //counts towards it
+  if (ic_messages > 0)
   {
-    ui_ic_chatlog->clear();
-
-    for (record_type_ptr record : m_ic_records)
-    {
-      ui_ic_chatlog->moveCursor(f_operation);
-      ui_ic_chatlog->textCursor().insertText(record->name, bold);
-      ui_ic_chatlog->textCursor().insertText(record->line + '\n', normal);
-    }
-    m_scroll_type_changed = false;
-  }
-
-  // new record
-  m_ic_records.append(std::make_shared<record_type>(p_name, p_text));
-
-  int len = m_ic_records.length();
+    ic_total_index_hits += f_index_hits - ic_index_hits;
+    ic_total_disk_checks += f_disk_checks - ic_disk_checks;
 
-  if (len > m_log_limit) // magic numbers, woo!
-  {
-    m_ic_records = m_ic_records.mid(len - m_log_limit);
+    qDebug() << "IC message asset lookups:" << f_index_hits - ic_index_hits << "from the index,"
+             << f_disk_checks - ic_disk_checks << "on the disk, averaging"
+             << ic_total_index_hits / ic_messages << "and" << ic_total_disk_checks / ic_messages
+             << "over" << ic_messages << "messages";
   }
 
+  ic_index_hits = f_index_hits;
+  ic_disk_checks = f_disk_checks;
+  ++ic_messages;
 
-  if(m_scroll_down)
-  {
-    ui_ic_chatlog->moveCursor(QTextCursor::End);
-    ui_ic_chatlog->textCursor().insertText(p_name, bold);
-    ui_ic_chatlog->textCursor().insertText(p_text + '\n', normal);
-  }
-  else
-  {
-    ui_ic_chatlog->clear();
+  qDebug() << "frame cache:" << ao_app->frame_cache->get_hits() << "hits," << ao_app->frame_cache->get_misses()
+           << "misses (" << ao_app->frame_cache->get_container_decodes() << "from containers),"
+           << ao_app->frame_cache->get_bytes() / 1024 << "KiB decoded";
+  qDebug() << "frame clock:" << ao_app->frame_clock->get_wakeups() << "wakeups for"
+           << ao_app->frame_clock->get_fired() << "timeouts";
 
-    for (record_type_ptr record : m_ic_records)
-    {
-      ui_ic_chatlog->moveCursor(QTextCursor::Start);
-      ui_ic_chatlog->textCursor().insertText(record->name, bold);
-      ui_ic_chatlog->textCursor().insertText(record->line + '\n', normal);
-    }
-  }
+  //as of the last batch the audio thread worked through
+  AOAudioEngine::audio_stats f_audio = ao_app->audio_engine->get_stats();
+  qDebug() << "audio engine:" << f_audio.commands << "commands," << f_audio.voices << "voices playing, peak"
+           << f_audio.peak_voices << "of" << AOAudioMixer::max_voices << "," << f_audio.played << "played,"
+           << f_audio.stolen << "cut off," << f_audio.dropped << "dropped,"
+           << "latency avg" << f_audio.average_latency << "us max" << f_audio.max_latency << "us,"
+           << "samples" << f_audio.sample_hits << "hits" << f_audio.sample_misses << "misses"
+           << f_audio.sample_bytes / 1024 << "KiB in" << f_audio.sample_handles << "handles";
+}
 
-  if (old_cursor.hasSelection() || !is_scrolled_up)
-  {
-    // The user has selected text or scrolled away from the top: maintain position.
-    ui_ic_chatlog->setTextCursor(old_cursor);
-    ui_ic_chatlog->verticalScrollBar()->setValue(old_scrollbar_value);
-  }
-  else
-  {
-    // The user hasn't selected any text and the scrollbar is at the top: scroll to the top.
-    ui_ic_chatlog->moveCursor(f_operation);
-    ui_ic_chatlog->verticalScrollBar()->setValue(ui_ic_chatlog->verticalScrollBar()->maximum());
-  }
+void Courtroom::append_ic_text(QString p_text, QString p_name)
+{
+  //the log drops the oldest record past the limit and keeps the user's place if they scrolled away
+  ui_ic_chatlog->append(p_name, p_text);
 }
 
 void Courtroom::play_preanim()
@@ -2011,7 +2044,6 @@ void Courtroom::start_chat_ticking()
 {
   ui_vp_message->clear();
   set_text_color();
-  rainbow_counter = 0;
   //we need to ensure that the text isn't already ticking because this function can be called by two logic paths
   if (text_state != 0)
     return;
@@ -2025,8 +2057,10 @@ void Courtroom::start_chat_ticking()
 
   ui_vp_chatbox->show();
 
+  //laid out once here, chat_tick only uncovers it
+  ui_vp_message->set_message(m_chatmessage[MESSAGE], get_message_formats(m_chatmessage[MESSAGE]));
+
   tick_pos = 0;
-  blip_pos = 0;
   chat_tick_timer->start(chat_tick_interval);
 
   QString f_gender = ao_app->get_gender(m_chatmessage[CHAR_NAME]);
@@ -2048,101 +2082,21 @@ void Courtroom::chat_tick()
   {
     text_state = 2;
     chat_tick_timer->stop();
+    m_blip_player->stop();
     anim_state = 3;
     ui_vp_player_char->play_idle(m_chatmessage[CHAR_NAME], m_chatmessage[EMOTE]);
-    m_string_color = "";
-    m_color_stack.clear();
   }
 
   else
   {
-    QString f_character = f_message.at(tick_pos);
-    f_character = f_character.toHtmlEscaped();
-    //qDebug() << f_character;
-
-    if (f_character == " ")
-      ui_vp_message->insertPlainText(" ");
-    else if (m_chatmessage[TEXT_COLOR].toInt() == RAINBOW)
-    {
-      QString html_color;
-
-      switch (rainbow_counter)
-      {
-      case 0:
-        html_color = "#FF0000";
-        break;
-      case 1:
-        html_color = "#FF7F00";
-        break;
-      case 2:
-        html_color = "#FFFF00";
-        break;
-      case 3:
-        html_color = "#00FF00";
-        break;
-      default:
-        html_color = "#2d96ff";
-        rainbow_counter = -1;
-      }
-
-      ++rainbow_counter;
-
-      ui_vp_message->insertHtml("<font color=\"" + html_color + "\">" + f_character + "</font>");
-    }
-    else if(ao_app->read_design_ini("enable_highlighting", ao_app->get_theme_path() + cc_config_ini) == "true")
-    {
-      bool found = false;
-      QVector<QStringList> f_vec = ao_app->get_highlight_color();
-      if(m_color_stack.isEmpty()) m_color_stack.push("");
-
-      for(const auto& col : f_vec)
-      {
-        if(f_character == col[0].trimmed()[0] && m_string_color != col[1].trimmed())
-        {
-          m_color_stack.push(col[1].trimmed());
-          m_string_color = m_color_stack.top();
-          found = true;
-          break;
-        }
-      }
-
-      //qDebug() << "character = " << f_character << "color=" << m_string_color;
-      ui_vp_message->insertHtml("<font color=\"" + m_string_color + "\">" + f_character + "</font>");
-
-      for(const auto& col : f_vec)
-      {
-        if(f_character == col[0].trimmed()[1] && !found)
-        {
-          if(m_color_stack.size() > 1) m_color_stack.pop();
-          m_string_color = m_color_stack.top();
-          break;
-        }
-
-      }
-    }
-    else
-    {
-      ui_vp_message->insertHtml(f_character);
-    }
-    QScrollBar *scroll = ui_vp_message->verticalScrollBar();
-    scroll->setValue(scroll->maximum());
+    //everything is laid out already, this only uncovers one more character
+    ui_vp_message->set_visible_length(tick_pos + 1);
 
-    if(blank_blip)
-      qDebug() << "blank_blip found true";
-
-    if ((f_message.at(tick_pos) != ' ' || blank_blip))
-    {
+    //blips keep their own time so tick jitter doesn't reach them, this only says if there's something to blip for
+    m_blip_player->set_quiet(f_message.at(tick_pos) == ' ' && !blank_blip);
 
-      if (blip_pos % blip_rate == 0)
-      {
-        blip_pos = 0;
-
-        // play blip
-        m_blip_player->play();
-      }
-
-      ++blip_pos;
-    }
+    if (tick_pos == 0)
+      m_blip_player->start(chat_tick_interval * blip_rate);
 
     ++tick_pos;
   }
@@ -2182,54 +2136,18 @@ void Courtroom::set_scene()
   if (testimony_in_progress)
     show_testimony();
 
-  //witness is default if pos is invalid
-  QString f_background = "witnessempty";
-  QString f_desk_image = "stand";
   QString f_desk_mod = m_chatmessage[DESK_MOD];
   QString f_side = m_chatmessage[SIDE];
 
-  if (f_side == "def")
-  {
-    f_background = "defenseempty";
-    if (is_ao2_bg)
-      f_desk_image = "defensedesk";
-    else
-      f_desk_image = "bancodefensa";
-  }
-  else if (f_side == "pro")
-  {
-    f_background = "prosecutorempty";
-    if (is_ao2_bg)
-      f_desk_image = "prosecutiondesk";
-    else
-      f_desk_image = "bancoacusacion";
-  }
-  else if (f_side == "jud")
-  {
-    f_background = "judgestand";
-    f_desk_image = "judgedesk";
-  }
-  else if (f_side == "hld")
-  {
-    f_background = "helperstand";
-    f_desk_image = "helperdesk";
-  }
-  else if (f_side == "hlp")
-  {
-    f_background = "prohelperstand";
-    f_desk_image = "prohelperdesk";
-  }
-  else
-  {
-    if (is_ao2_bg)
-      f_desk_image = "stand";
-    else
-      f_desk_image = "estrado";
-  }
+  //a no-op unless the theme resized the viewport or files changed since the background was set
+  scene_cache->load(get_background_path(), is_ao2_bg, ui_viewport->size());
+
+  AOSceneCache::side f_scene = scene_cache->get_side(f_side);
 
-  ui_vp_background->set_image(f_background);
-  ui_vp_desk->set_image(f_desk_image);
-  ui_vp_legacy_desk->set_legacy_desk(f_desk_image);
+  ui_vp_background->set_frames(f_scene.background, f_scene.background_frames);
+  ui_vp_desk->set_frames(f_scene.desk, f_scene.desk_frames);
+  m_legacy_desk = f_scene.legacy_desk;
+  ui_vp_legacy_desk->set_legacy_desk(scene_cache->get_legacy_desk(m_legacy_desk));
 
   if (f_desk_mod == "0" || (f_desk_mod != "1" &&
                             (f_side == "jud" ||
@@ -2261,6 +2179,101 @@ void Courtroom::set_scene()
   }
 }
 
+void Courtroom::on_legacy_desk_finished()
+{
+  //the desk on screen may have been left empty while it was being scaled
+  if (!m_legacy_desk || m_legacy_desk->converted)
+    return;
+
+  ui_vp_legacy_desk->set_legacy_desk(scene_cache->get_legacy_desk(m_legacy_desk));
+}
+
+QVector<QTextLayout::FormatRange> Courtroom::get_message_formats(QString p_message)
+{
+  QVector<QTextLayout::FormatRange> f_formats;
+
+  bool is_rainbow = m_chatmessage[TEXT_COLOR].toInt() == RAINBOW;
+  bool is_highlighted = !is_rainbow &&
+      ao_app->read_design_ini("enable_highlighting", ao_app->get_theme_path() + cc_config_ini) == "true";
+
+  if (!is_rainbow && !is_highlighted)
+    return f_formats;
+
+  QVector<QStringList> f_vec;
+  if (is_highlighted)
+    f_vec = ao_app->get_highlight_color();
+
+  const QStringList rainbow_colors = {"#FF0000", "#FF7F00", "#FFFF00", "#00FF00", "#2d96ff"};
+  int rainbow_counter = 0;
+
+  QStack<QString> f_color_stack;
+  f_color_stack.push("");
+  QString f_string_color = "";
+
+  for (int n_char = 0 ; n_char < p_message.size() ; ++n_char)
+  {
+    QChar f_character = p_message.at(n_char);
+
+    //spaces never got a color of their own
+    if (f_character == ' ')
+      continue;
+
+    QString f_color;
+
+    if (is_rainbow)
+    {
+      f_color = rainbow_colors.at(rainbow_counter);
+      rainbow_counter = (rainbow_counter + 1) % rainbow_colors.size();
+    }
+    else
+    {
+      bool found = false;
+
+      for(const auto& col : f_vec)
+      {
+        if(f_character == col[0].trimmed()[0] && f_string_color != col[1].trimmed())
+        {
+          f_color_stack.push(col[1].trimmed());
+          f_string_color = f_color_stack.top();
+          found = true;
+          break;
+        }
+      }
+
+      f_color = f_string_color;
+
+      for(const auto& col : f_vec)
+      {
+        if(f_character == col[0].trimmed()[1] && !found)
+        {
+          if(f_color_stack.size() > 1) f_color_stack.pop();
+          f_string_color = f_color_stack.top();
+          break;
+        }
+      }
+    }
+
+    if (f_color == "")
+      continue;
+
+    //runs of the same color share one range
+    if (!f_formats.isEmpty() && f_formats.last().start + f_formats.last().length == n_char &&
+        f_formats.last().format.foreground().color() == QColor(f_color))
+    {
+      ++f_formats.last().length;
+      continue;
+    }
+
+    QTextLayout::FormatRange f_range;
+    f_range.start = n_char;
+    f_range.length = 1;
+    f_range.format.setForeground(QColor(f_color));
+    f_formats.append(f_range);
+  }
+
+  return f_formats;
+}
+
 void Courtroom::set_text_color()
 {
   switch (m_chatmessage[TEXT_COLOR].toInt())
@@ -2340,20 +2353,10 @@ void Courtroom::handle_song(QStringList *p_contents)
   if (f_contents.size() < 2)
     return;
 
+  //the extension is looked for on the music player's thread
   QString f_song = f_contents.at(0);
   int n_char = f_contents.at(1).toInt();
 
-  for (auto& ext : QStringList { "", ".wav", ".ogg", ".mp3" })
-  {
-    QString r_song = f_song + ext;
-    QString song_path = ao_app->get_base_path() + "sounds/music/" + r_song.toLower();
-    if (file_exists(song_path))
-    {
-      f_song = r_song;
-      break;
-    }
-  }
-
   if (n_char < 0 || n_char >= char_list.size())
   {
     m_music_player->play(f_song);
@@ -2509,6 +2512,20 @@ void Courtroom::on_ooc_return_pressed()
     rainbow_appended = true;
     return;
   }
+  else if (ooc_message == "/logsearch" || ooc_message.startsWith("/logsearch "))
+  {
+    //client side, the server never sees it
+    if (ui_log_search == nullptr)
+      ui_log_search = new AOChatSearch(ao_app->get_base_path() + "logs/", this);
+
+    ui_log_search->set_query(ooc_message.mid(QString("/logsearch").size()).trimmed());
+    ui_log_search->show();
+    ui_log_search->raise();
+    ui_log_search->activateWindow();
+
+    ui_ooc_chat_message->clear();
+    return;
+  }
 
   QStringList packet_contents;
   packet_contents.append(ui_ooc_chat_name->text());
@@ -2660,6 +2677,15 @@ void Courtroom::on_music_list_clicked()
   ui_ic_chat_message->setFocus();
 }
 
+void Courtroom::on_music_list_highlighted(int p_row)
+{
+  if (p_row < 0 || p_row >= ui_music_list->count())
+    return;
+
+  //likely to be double-clicked next, it's ready by then
+  m_music_player->prefetch(ui_music_list->item(p_row)->text());
+}
+
 void Courtroom::on_music_list_double_clicked(QModelIndex p_model)
 {
   if (is_muted)
@@ -3002,7 +3028,23 @@ void Courtroom::on_note_button_clicked()
 
 void Courtroom::on_note_text_changed()
 {
-  ao_app->write_note(ui_vp_notepad->toPlainText(), current_file);
+  //this fires on every keystroke, so only restart the countdown here
+  note_dirty = true;
+  note_save_timer->start();
+}
+
+void Courtroom::autosave_note()
+{
+  save_note();
+}
+
+void Courtroom::on_note_focus_lost()
+{
+  if (!note_dirty)
+    return;
+
+  save_note();
+  ao_app->file_writer->start_write();
 }
 
 void Courtroom::ping_server()
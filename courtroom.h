@@ -10,7 +10,6 @@
 #include "aomovie.h"
 #include "aocharmovie.h"
 
-#include "aobasshandle.hpp"
 #include "aoblipplayer.h"
 #include "aomusicplayer.h"
 #include "aosfxplayer.h"
@@ -24,6 +23,11 @@
 #include "aonotepad.h"
 #include "aonotearea.hpp"
 #include "aolabel.hpp"
+#include "aoviewport.hpp"
+#include "aoscenecache.hpp"
+#include "aomessagedisplay.hpp"
+#include "aoiclog.hpp"
+#include "aochatsearch.hpp"
 #include "datatypes.h"
 
 #include <QMainWindow>
@@ -51,6 +55,7 @@ class Courtroom : public QMainWindow
   Q_OBJECT
 public:
   explicit Courtroom(AOApplication *p_ao_app);
+  ~Courtroom();
 
   void append_char(char_type p_char){char_list.append(p_char);}
   void append_evidence(evi_type p_evi){evidence_list.append(p_evi);}
@@ -74,6 +79,9 @@ public:
   //reads theme inis and sets size and pos based on the identifier
   void set_size_and_pos(QWidget *p_widget, QString p_identifier);
 
+  //same for the viewport's layers, whose theme positions are relative to the courtroom too
+  void set_layer_size_and_pos(QLabel *p_layer, QString p_identifier);
+
   //sets status as taken on character with cid n_char and places proper shading on charselect
   void set_taken(int n_char, bool p_taken);
 
@@ -95,6 +103,9 @@ public:
   //sets text color based on text color in chatmessage
   void set_text_color();
 
+  //Returns the rainbow or highlight colors of p_message, worked out once before it starts ticking
+  QVector<QTextLayout::FormatRange> get_message_formats(QString p_message);
+
   //takes in serverD-formatted IP list as prints a converted version to server OOC
   //admittedly poorly named
   void set_ip_list(QString p_list);
@@ -144,6 +155,8 @@ public:
   void handle_chatmessage(QStringList *p_contents);
   void handle_chatmessage_2();
   void handle_chatmessage_3();
+  //logs what the previous IC message cost now that the next one starts
+  void log_ic_stats();
 
   //handles character portrait animation
   void handle_char_anim(AOCharMovie *charPlayer);
@@ -200,43 +213,42 @@ private:
   QTimer *keepalive_timer;
 
   //determines how fast messages tick onto screen
-  QTimer *chat_tick_timer;
+  AOClockTimer *chat_tick_timer;
   int chat_tick_interval = 60;
   //which tick position(character in chat message) we are at
   int tick_pos = 0;
-  //used to determine how often blips sound
-  int blip_pos = 0;
+  //blips sound every blip_rate ticks
   int blip_rate = 1;
-  int rainbow_counter = 0;
   bool rainbow_appended = false;
   bool blank_blip = false;
   bool note_shown = false;
+  //true while the notepad has edits that haven't been handed to the file writer
+  bool note_dirty = false;
   bool contains_add_button = false;
 
   //////////////
   QScrollArea *note_scroll_area;
 
+  //waits for a pause in typing before the notepad is saved
+  QTimer *note_save_timer;
+  const int note_save_delay = 750;
+
   //delay before chat messages starts ticking
-  QTimer *text_delay_timer;
+  AOClockTimer *text_delay_timer;
 
   //delay before sfx plays
-  QTimer *sfx_delay_timer;
+  AOClockTimer *sfx_delay_timer;
 
   //keeps track of how long realization is visible(it's just a white square and should be visible less than a second)
-  QTimer *realization_timer;
+  AOClockTimer *realization_timer;
 
   //times how long the blinking testimony should be shown(green one in the corner)
-  QTimer *testimony_show_timer;
+  AOClockTimer *testimony_show_timer;
   //times how long the blinking testimony should be hidden
-  QTimer *testimony_hide_timer;
-
-  //Generate a File Name based on the time you launched the client
-  QString icchatlogsfilename = QDateTime::currentDateTime().toString("'logs/'ddd MMMM yyyy hh.mm.ss.z'.txt'");
+  AOClockTimer *testimony_hide_timer;
 
   //configuration files locations
-  QString rpc_ini = "configs/rpccharlist.ini";
   QString file_select_ini = "configs/filesabstract.ini";
-  QString shownames_ini = "configs/shownames.ini";
   //theme files locations
   QString design_ini = "courtroom_design.ini";
   QString fonts_ini = "courtroom_fonts.ini";
@@ -252,9 +264,15 @@ private:
 
   QString previous_ic_message = "";
 
-  QString m_string_color = "";
-
-  QStack<QString> m_color_stack;
+  //set "ic_stats = true" in config.ini to log what every IC message costs
+  bool m_log_ic_stats = false;
+  //asset lookups counted when the current message came in, to see what one message costs
+  int ic_index_hits = 0;
+  int ic_disk_checks = 0;
+  //messages counted so far, and what the finished ones looked up in total
+  int ic_messages = 0;
+  int ic_total_index_hits = 0;
+  int ic_total_disk_checks = 0;
 
   bool testimony_in_progress = false;
 
@@ -308,8 +326,6 @@ private:
 
   int m_log_limit = 200;
   bool m_scroll_down = false;
-  bool m_previously_scroll_down = false;
-  bool m_scroll_type_changed = false;
 
 //  int note_amount = 0;
 
@@ -329,6 +345,11 @@ private:
 
   QString current_background = "gs4";
 
+  //every side of current_background, ready to be switched to
+  AOSceneCache *scene_cache;
+  //the legacy desk of the side on screen, it may still be scaled when the side is set
+  legacy_desk_ptr m_legacy_desk;
+
   AOBlipPlayer*  m_blip_player = nullptr;
   AOSfxPlayer*   m_mod_player = nullptr;
   AOMusicPlayer* m_music_player = nullptr;
@@ -338,7 +359,7 @@ private:
 
   AOImage *ui_background;
 
-  QWidget *ui_viewport;
+  AOViewport *ui_viewport;
   AOScene *ui_vp_background;
   AOMovie *ui_vp_speedlines;
   AOCharMovie *ui_vp_player_char;
@@ -350,16 +371,12 @@ private:
 
 //  AONotepad *ui_vp_notepad;
 
-  // list of characters that require a second application ID
-  // note that since it's hardcoded, it won't be of much use in other servers
-  QVector<QString> rpc_char_list;
-
   AOImage *ui_vp_notepad_image;
-  QTextEdit *ui_vp_notepad;
+  AONotepad *ui_vp_notepad;
 
   AOImage* ui_vp_chatbox = nullptr;
   QLabel* ui_vp_showname = nullptr;
-  QTextEdit* ui_vp_message = nullptr;
+  AOMessageDisplay* ui_vp_message = nullptr;
   AOImage* ui_vp_testimony = nullptr;
   AOMovie* ui_vp_effect = nullptr;
   AOMovie* ui_vp_wtce = nullptr;
@@ -375,8 +392,9 @@ private:
 
   QWidget *ui_vp_music_area;
 
-  QTextEdit* ui_ic_chatlog = nullptr;
-  QVector<record_type_ptr> m_ic_records;
+  AOICLog* ui_ic_chatlog = nullptr;
+  //made the first time /logsearch is used
+  AOChatSearch *ui_log_search = nullptr;
 
   AOTextArea *ui_ms_chatlog;
   AOTextArea *ui_server_chatlog;
@@ -538,8 +556,6 @@ private:
   void save_note();
   void save_textlog(QString p_text);
 
-  void set_char_rpc();
-
 
 public slots:
   void objection_done();
@@ -556,6 +572,8 @@ private slots:
   void start_chat_ticking();
   void play_sfx();
 
+  void on_legacy_desk_finished();
+
   void chat_tick();
 
   void on_mute_list_clicked(QModelIndex p_index);
@@ -567,6 +585,7 @@ private slots:
   void on_music_search_edited(QString p_text);
   void on_music_list_clicked();
   void on_music_list_double_clicked(QModelIndex p_model);
+  void on_music_list_highlighted(int p_row);
 
   void on_sfx_search_edited(QString p_text);
 
@@ -649,6 +668,8 @@ private slots:
   void on_set_notes_clicked();
 
   void on_note_text_changed();
+  void on_note_focus_lost();
+  void autosave_note();
 
   void on_pre_clicked();
   void on_flip_clicked();
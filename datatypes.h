@@ -1,7 +1,6 @@
 #ifndef DATATYPES_H
 #define DATATYPES_H
 
-#include <memory>
 #include <QString>
 
 struct record_type
@@ -15,8 +14,6 @@ struct record_type
     QString line;
 };
 
-typedef std::shared_ptr<record_type> record_type_ptr;
-
 struct server_type
 {
     QString name;
@@ -1,15 +1,55 @@
 #include <QFileInfo>
 #include <QDir>
+#include <QAtomicInt>
+#include <QBuffer>
 
 #include "file_functions.h"
+#include "aoassetindex.hpp"
+#include "aoassetpack.hpp"
 
-bool file_exists(QString file_path)
+static QAtomicInt disk_checks;
+
+static bool loose_file_exists(QString file_path)
 {
+  //the index answers most of these without touching the disk
+  AOAssetIndex *index = AOAssetIndex::instance();
+  bool exists = false;
+
+  if (index != nullptr && index->lookup_file(file_path, exists))
+    return exists;
+
+  disk_checks.ref();
+
   QFileInfo check_file(file_path);
 
   return check_file.exists() && check_file.isFile();
 }
 
+static bool loose_dir_exists(QString dir_path)
+{
+  AOAssetIndex *index = AOAssetIndex::instance();
+  bool exists = false;
+
+  if (index != nullptr && index->lookup_dir(dir_path, exists))
+    return exists;
+
+  disk_checks.ref();
+
+  QDir check_dir(dir_path);
+
+  return check_dir.exists();
+}
+
+bool file_exists(QString file_path)
+{
+  if (loose_file_exists(file_path))
+    return true;
+
+  AOAssetPack *pack = AOAssetPack::instance();
+
+  return pack != nullptr && pack->contains_file(file_path);
+}
+
 QString file_exists(QString file_path, QVector<QString> p_exts)
 {
   for(auto &ext : p_exts)
@@ -22,7 +62,68 @@ QString file_exists(QString file_path, QVector<QString> p_exts)
 
 bool dir_exists(QString dir_path)
 {
-  QDir check_dir(dir_path);
+  if (loose_dir_exists(dir_path))
+    return true;
 
-  return check_dir.exists();
+  AOAssetPack *pack = AOAssetPack::instance();
+
+  return pack != nullptr && pack->contains_dir(dir_path);
+}
+
+int get_disk_check_count()
+{
+  return disk_checks.load();
+}
+
+bool is_packed_asset(QString file_path)
+{
+  AOAssetPack *pack = AOAssetPack::instance();
+
+  //checking the pack first saves a disk lookup for everyone without one
+  return pack != nullptr && pack->contains_file(file_path) && !loose_file_exists(file_path);
+}
+
+QByteArray read_asset(QString file_path)
+{
+  if (is_packed_asset(file_path))
+    return AOAssetPack::instance()->read(file_path);
+
+  QFile f_file(file_path);
+  if (!f_file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  return f_file.readAll();
+}
+
+QIODevice *open_asset(QString file_path)
+{
+  QIODevice *f_device;
+
+  if (is_packed_asset(file_path))
+  {
+    QBuffer *f_buffer = new QBuffer();
+    f_buffer->setData(AOAssetPack::instance()->read(file_path));
+    f_device = f_buffer;
+  }
+  else
+    f_device = new QFile(file_path);
+
+  if (!f_device->open(QIODevice::ReadOnly))
+  {
+    delete f_device;
+    return nullptr;
+  }
+
+  return f_device;
+}
+
+QPixmap load_pixmap(QString file_path)
+{
+  if (!is_packed_asset(file_path))
+    return QPixmap(file_path);
+
+  QPixmap f_pixmap;
+  f_pixmap.loadFromData(read_asset(file_path));
+
+  return f_pixmap;
 }
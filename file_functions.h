@@ -3,9 +3,24 @@
 
 #include <QString>
 #include <QVector>
+#include <QByteArray>
+#include <QIODevice>
+#include <QPixmap>
 
 bool file_exists(QString file_path);
 QString file_exists(QString file_path, QVector<QString> p_exts);
 bool dir_exists(QString file_path);
 
+//Returns how many existence checks had to ask the disk so far
+int get_disk_check_count();
+
+//Returns true if file_path only exists inside the asset pack
+bool is_packed_asset(QString file_path);
+
+//These read from the loose file if there is one and from the asset pack otherwise
+QByteArray read_asset(QString file_path);
+//Returns an opened device the caller has to delete, or nullptr
+QIODevice *open_asset(QString file_path);
+QPixmap load_pixmap(QString file_path);
+
 #endif // FILE_FUNCTIONS_H
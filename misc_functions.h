@@ -1,6 +0,0 @@
-#ifndef MISC_FUNCTIONS_H
-#define MISC_FUNCTIONS_H
-
-void delay(int p_milliseconds);
-
-#endif // MISC_FUNCTIONS_H
@@ -7,11 +7,16 @@
 #include <QVector>
 #include <QDebug>
 #include <QColor>
+#include <QScopedPointer>
 
 QString AOApplication::read_config(QString searchline)
 {
   QString return_value = "";
 
+  //a value that is still waiting to be written is newer than what's on the disk
+  if (file_writer->get_pending_ini_value(get_base_path() + "config.ini", searchline, return_value))
+    return return_value;
+
   QFile config_file(get_base_path() + "config.ini");
   if (!config_file.open(QIODevice::ReadOnly))
       return return_value;
@@ -114,58 +119,15 @@ QStringList AOApplication::get_call_words()
 
 void AOApplication::write_theme(QString theme)
 {
-    QString filename = get_base_path() + "config.ini";
-    QFile config_file(filename);
-
-    if(!config_file.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        qDebug() << "Couldn't open config.ini";
-        return;
-    }
-
-    QTextStream in(&config_file);
-
-    QByteArray t = "";
-
-    while(!in.atEnd())
-    {
-        QString f_line = in.readLine();
-        if(!f_line.startsWith("theme"))
-        {
-            t += f_line + "\n";
-            continue;
-        }
-
-        QStringList line_elements = f_line.split("=");
-
-        if(line_elements.at(0).trimmed() != "theme")
-        {
-            t += f_line + "\n";
-            continue;
-        }
-
-        if(line_elements.size() < 2)
-        {
-            t += f_line +"\n";
-            continue;
-        }
-        t += "theme = " + theme + "\n";
-    }
-    config_file.close();
-
-    QFile ex(filename);
-    if(!ex.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
-    {
-        qDebug() << "Couldn't open config.ini";
-        return;
-    }
-
-    ex.write(t);
-    ex.close();
+    file_writer->set_ini_value(get_base_path() + "config.ini", "theme", theme);
 }
 
 QString AOApplication::read_note(QString filename)
 {
+    QByteArray pending_text;
+    if(file_writer->get_pending_contents(filename, pending_text))
+        return QString::fromLocal8Bit(pending_text);
+
     QFile note_txt(filename);
 
     if(!note_txt.open(QIODevice::ReadOnly | QFile::Text))
@@ -182,66 +144,28 @@ QString AOApplication::read_note(QString filename)
 
 void AOApplication::write_note(QString p_text, QString p_file)
 {
-    QFile f_log(p_file);
-    if(f_log.open(QIODevice::WriteOnly | QFile::Text))
-    {
-        QTextStream out(&f_log);
-
-        out << p_text;
-
-        f_log.flush();
-        f_log.close();
-    }
-}
-
-void AOApplication::append_note(QString p_line, QString p_file)
-{
-  QFile f_log(p_file);
-  if(f_log.open(QIODevice::WriteOnly | QIODevice::Append))
-    {
-      QTextStream out(&f_log);
-
-      out << p_line << "\r\n";
-
-      f_log.flush();
-      f_log.close();
-    }
+    //saving a note next to the assets shouldn't look like the assets changed
+    asset_index->ignore_file(p_file);
+    file_writer->write_file(p_file, p_text.toLocal8Bit());
 }
 
 void AOApplication::write_to_serverlist_txt(QString p_line)
 {
-  QFile serverlist_txt;
   QString serverlist_txt_path = get_base_path() + "serverlist.txt";
 
-  serverlist_txt.setFileName(serverlist_txt_path);
-
-  if (!serverlist_txt.open(QIODevice::WriteOnly | QIODevice::Append))
-  {
-    return;
-  }
-
-  QTextStream out(&serverlist_txt);
-
-  out << "\r\n" << p_line;
-
-  serverlist_txt.close();
+  file_writer->append_to_file(serverlist_txt_path, ("\r\n" + p_line).toLocal8Bit());
 }
 
 QVector<server_type> AOApplication::read_serverlist_txt()
 {
   QVector<server_type> f_server_list;
 
-  QFile serverlist_txt;
   QString serverlist_txt_path = get_base_path() + "serverlist.txt";
 
-  serverlist_txt.setFileName(serverlist_txt_path);
+  //favorites that were just added may still be queued, they're read along with the file
+  QByteArray serverlist_txt = file_writer->read_file(serverlist_txt_path);
 
-  if (!serverlist_txt.open(QIODevice::ReadOnly))
-  {
-    return f_server_list;
-  }
-
-  QTextStream in(&serverlist_txt);
+  QTextStream in(&serverlist_txt, QIODevice::ReadOnly);
 
   while(!in.atEnd())
   {
@@ -265,15 +189,13 @@ QVector<server_type> AOApplication::read_serverlist_txt()
 
 QString AOApplication::read_design_ini(QString p_identifier, QString p_design_path)
 {
-  QFile design_ini;
-
-  design_ini.setFileName(p_design_path);
+  QScopedPointer<QIODevice> design_ini(open_asset(p_design_path));
 
-  if (!design_ini.open(QIODevice::ReadOnly))
+  if (!design_ini)
   {
     return "";
   }
-  QTextStream in(&design_ini);
+  QTextStream in(design_ini.data());
 
   QString result = "";
 
@@ -296,7 +218,7 @@ QString AOApplication::read_design_ini(QString p_identifier, QString p_design_pa
     break;
   }
 
-  design_ini.close();
+  design_ini->close();
 
   return result;
 }
@@ -434,14 +356,12 @@ QString AOApplication::get_stylesheet(QString target_tag, QString p_file)
 {
   QString design_ini_path = get_theme_path() + p_file;
 
-  QFile design_ini;
+  QScopedPointer<QIODevice> design_ini(open_asset(design_ini_path));
 
-  design_ini.setFileName(design_ini_path);
-
-  if(!design_ini.open(QIODevice::ReadOnly))
+  if(!design_ini)
     return "";
 
-  QTextStream in(&design_ini);
+  QTextStream in(design_ini.data());
 
   QString f_text;
 
@@ -465,7 +385,7 @@ QString AOApplication::get_stylesheet(QString target_tag, QString p_file)
       }
   }
 
-  design_ini.close();
+  design_ini->close();
   return f_text;
 }
 
@@ -473,16 +393,14 @@ QVector<QStringList> AOApplication::get_highlight_color()
 {
   QString design_ini_path = get_theme_path() + "courtroom_config.ini";
 
-  QFile design_ini;
-
-  design_ini.setFileName(design_ini_path);
+  QScopedPointer<QIODevice> design_ini(open_asset(design_ini_path));
 
   QVector<QStringList> f_vec;
 
-  if(!design_ini.open(QIODevice::ReadOnly))
+  if(!design_ini)
     return f_vec;
 
-  QTextStream in(&design_ini);
+  QTextStream in(design_ini.data());
 
   bool tag_found = false;
 
@@ -504,7 +422,7 @@ QVector<QStringList> AOApplication::get_highlight_color()
       }
   }
 
-  design_ini.close();
+  design_ini->close();
   return f_vec;
 }
 
@@ -569,14 +487,12 @@ QString AOApplication::read_char_ini(QString p_char, QString p_search_line, QStr
 {
   QString char_ini_path = get_character_path(p_char) + "char.ini";
 
-  QFile char_ini;
+  QScopedPointer<QIODevice> char_ini(open_asset(char_ini_path));
 
-  char_ini.setFileName(char_ini_path);
-
-  if (!char_ini.open(QIODevice::ReadOnly))
+  if (!char_ini)
     return "";
 
-  QTextStream in(&char_ini);
+  QTextStream in(char_ini.data());
 
   bool tag_found = false;
 
@@ -606,12 +522,12 @@ QString AOApplication::read_char_ini(QString p_char, QString p_search_line, QStr
 
     if (tag_found)
     {
-      char_ini.close();
+      char_ini->close();
       return line_elements.at(1).trimmed();
     }
   }
 
-  char_ini.close();
+  char_ini->close();
   return "";
 }
 
@@ -624,38 +540,6 @@ QString AOApplication::get_char_name(QString p_char)
   else return f_result;
 }
 
-QString AOApplication::get_showname(QString p_char)
-{
-  QString f_result = read_showname(p_char);
-  if(f_result == "")
-    f_result = read_char_ini(p_char, "showname", "[Options]", "[Time]");
-
-  if (f_result == "")
-    return p_char;
-  else return f_result;
-}
-
-QString AOApplication::read_showname(QString p_char)
-{
-  QString f_filename = get_base_path() + "configs/shownames.ini";
-  QFile f_file(f_filename);
-  if(!f_file.open(QIODevice::ReadOnly))
-  { qDebug() << "Error reading" << f_filename; return ""; }
-
-  QTextStream in(&f_file);
-  while(!in.atEnd())
-  {
-    QString f_line = in.readLine();
-    if(!f_line.startsWith(p_char))
-      continue;
-
-    QStringList line_elements = f_line.split("=");
-    if(line_elements.at(0).trimmed() == p_char)
-      return line_elements.at(1).trimmed();
-  }
-  return "";
-}
-
 QString AOApplication::get_char_side(QString p_char)
 {
   QString f_result = read_char_ini(p_char, "side", "[Options]", "[Time]");
@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Compiles character animations into animations.aoc frame containers
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+TARGET = aoc
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += main.cpp \
+    ../../aoframecontainer.cpp \
+    ../../aolz4.cpp
+
+HEADERS += ../../aoframecontainer.hpp \
+    ../../aolz4.hpp
@@ -0,0 +1,394 @@
+#include "aoframecontainer.hpp"
+#include "aolz4.hpp"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QDateTime>
+#include <QImage>
+#include <QImageReader>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+#include <QTextStream>
+
+struct frame_entry
+{
+  quint32 delay = 0;
+  quint32 stored_size = 0;
+  quint64 data_offset = 0;
+};
+
+struct animation_entry
+{
+  QByteArray name;
+  quint32 name_offset = 0;
+  quint32 width = 0;
+  quint32 height = 0;
+  quint32 flags = 0;
+  QVector<frame_entry> frames;
+  quint64 frames_offset = 0;
+  quint64 palette_offset = 0;
+  quint32 palette_size = 0;
+  quint64 source_size = 0;
+  quint64 source_time = 0;
+};
+
+static const QStringList animated_suffixes = {"gif", "apng", "png"};
+
+static QTextStream &out()
+{
+  static QTextStream f_stream(stdout);
+  return f_stream;
+}
+
+//Returns the preanimations char.ini lists, the (a) and (b) emotes are found by their names
+static QSet<QString> get_preanims(QDir p_dir)
+{
+  QSet<QString> f_preanims;
+
+  QStringList f_inis = p_dir.entryList(QStringList{"char.ini"}, QDir::Files);
+  for (QString f_file : p_dir.entryList(QDir::Files))
+  {
+    if (f_file.toLower() == "char.ini" && !f_inis.contains(f_file))
+      f_inis.append(f_file);
+  }
+
+  if (f_inis.isEmpty())
+    return f_preanims;
+
+  QFile f_ini(p_dir.filePath(f_inis.first()));
+  if (!f_ini.open(QIODevice::ReadOnly | QIODevice::Text))
+    return f_preanims;
+
+  QTextStream in(&f_ini);
+  bool in_emotions = false;
+
+  while (!in.atEnd())
+  {
+    QString f_line = in.readLine().trimmed();
+
+    if (f_line.startsWith("["))
+    {
+      in_emotions = f_line.toLower() == "[emotions]";
+      continue;
+    }
+
+    int f_equals = f_line.indexOf("=");
+    if (!in_emotions || f_equals < 0)
+      continue;
+
+    //comment#preanim#emote#mod
+    QStringList f_fields = f_line.mid(f_equals + 1).trimmed().split("#");
+    if (f_fields.size() < 2)
+      continue;
+
+    QString f_preanim = f_fields.at(1).trimmed().toLower();
+    if (f_preanim != "" && f_preanim != "-")
+      f_preanims.insert(f_preanim);
+  }
+
+  return f_preanims;
+}
+
+static void align(QSaveFile &p_file, quint64 &p_offset)
+{
+  while (p_offset % 4 != 0)
+  {
+    p_file.write("\0", 1);
+    ++p_offset;
+  }
+}
+
+static bool compile_animation(QString p_path, animation_entry &p_entry, QSaveFile &p_file, quint64 &p_offset,
+                              bool p_indexed, bool p_lz4)
+{
+  QImageReader f_reader(p_path);
+  QVector<QImage> f_images;
+  QVector<int> f_delays;
+
+  QImage f_image = f_reader.read();
+  while (!f_image.isNull())
+  {
+    f_images.append(f_image.convertToFormat(QImage::Format_ARGB32));
+    f_delays.append(f_reader.nextImageDelay());
+    f_image = f_reader.read();
+  }
+
+  if (f_images.isEmpty())
+  {
+    out() << "  skipping " << p_path << ", it doesn't decode" << endl;
+    return false;
+  }
+
+  QSize f_size = f_images.first().size();
+  for (const QImage &f_frame : f_images)
+  {
+    if (f_frame.size() != f_size)
+    {
+      out() << "  skipping " << p_path << ", its frames differ in size" << endl;
+      return false;
+    }
+  }
+
+  p_entry.width = f_size.width();
+  p_entry.height = f_size.height();
+
+  //palette indexing only works if the whole animation gets by with 256 colors
+  QHash<QRgb, int> f_palette;
+  if (p_indexed)
+  {
+    for (const QImage &f_frame : f_images)
+    {
+      for (int n_row = 0 ; n_row < f_frame.height() && f_palette.size() <= 256 ; ++n_row)
+      {
+        const QRgb *f_line = reinterpret_cast<const QRgb*>(f_frame.constScanLine(n_row));
+        for (int n_pixel = 0 ; n_pixel < f_frame.width() ; ++n_pixel)
+        {
+          //every fully transparent pixel is the same color
+          QRgb f_color = qAlpha(f_line[n_pixel]) == 0 ? 0 : f_line[n_pixel];
+          if (!f_palette.contains(f_color))
+            f_palette.insert(f_color, f_palette.size());
+        }
+      }
+    }
+  }
+
+  if (p_indexed && f_palette.size() <= 256)
+    p_entry.flags |= AOFrameContainer::INDEXED;
+  if (p_lz4)
+    p_entry.flags |= AOFrameContainer::LZ4;
+
+  for (int n_frame = 0 ; n_frame < f_images.size() ; ++n_frame)
+  {
+    const QImage &f_frame = f_images.at(n_frame);
+    QByteArray f_data;
+
+    if (p_entry.flags & AOFrameContainer::INDEXED)
+    {
+      f_data.reserve(f_frame.width() * f_frame.height());
+
+      for (int n_row = 0 ; n_row < f_frame.height() ; ++n_row)
+      {
+        const QRgb *f_line = reinterpret_cast<const QRgb*>(f_frame.constScanLine(n_row));
+        for (int n_pixel = 0 ; n_pixel < f_frame.width() ; ++n_pixel)
+        {
+          QRgb f_color = qAlpha(f_line[n_pixel]) == 0 ? 0 : f_line[n_pixel];
+          f_data.append(char(f_palette.value(f_color)));
+        }
+      }
+    }
+    else
+    {
+      //the pixels the player would end up with after decoding the gif
+      QImage f_premultiplied = f_frame.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+      for (int n_row = 0 ; n_row < f_premultiplied.height() ; ++n_row)
+        f_data.append(reinterpret_cast<const char*>(f_premultiplied.constScanLine(n_row)), f_premultiplied.width() * 4);
+    }
+
+    if (p_entry.flags & AOFrameContainer::LZ4)
+      f_data = lz4_compress(f_data.constData(), f_data.size());
+
+    align(p_file, p_offset);
+
+    frame_entry f_entry;
+    f_entry.delay = f_delays.at(n_frame);
+    f_entry.stored_size = f_data.size();
+    f_entry.data_offset = p_offset;
+    p_entry.frames.append(f_entry);
+
+    p_file.write(f_data);
+    p_offset += f_data.size();
+  }
+
+  if (p_entry.flags & AOFrameContainer::INDEXED)
+  {
+    QVector<QRgb> f_colors(f_palette.size());
+    for (QHash<QRgb, int>::const_iterator it = f_palette.constBegin() ; it != f_palette.constEnd() ; ++it)
+      f_colors[it.value()] = it.key();
+
+    align(p_file, p_offset);
+    p_entry.palette_offset = p_offset;
+    p_entry.palette_size = f_colors.size();
+
+    QDataStream f_stream(&p_file);
+    f_stream.setByteOrder(QDataStream::LittleEndian);
+    for (QRgb f_color : f_colors)
+      f_stream << quint32(f_color);
+
+    p_offset += f_colors.size() * 4;
+  }
+
+  QFileInfo f_info(p_path);
+  p_entry.source_size = f_info.size();
+  p_entry.source_time = f_info.lastModified().toMSecsSinceEpoch();
+
+  return true;
+}
+
+static bool compile_character(QString p_folder, bool p_indexed, bool p_lz4)
+{
+  QDir f_dir(p_folder);
+  if (!f_dir.exists())
+  {
+    out() << "no such directory: " << p_folder << endl;
+    return false;
+  }
+
+  QSet<QString> f_preanims = get_preanims(f_dir);
+  QStringList f_sources;
+
+  for (QString f_file : f_dir.entryList(QDir::Files, QDir::Name))
+  {
+    QFileInfo f_info(f_file);
+    QString f_lower = f_file.toLower();
+
+    if (!animated_suffixes.contains(f_info.suffix().toLower()))
+      continue;
+
+    if (f_lower.startsWith("(a)") || f_lower.startsWith("(b)") || f_preanims.contains(f_info.completeBaseName().toLower()))
+      f_sources.append(f_file);
+  }
+
+  QString f_target = f_dir.filePath("animations.aoc");
+
+  if (f_sources.isEmpty())
+  {
+    out() << p_folder << ": nothing to compile" << endl;
+    return true;
+  }
+
+  QSaveFile f_container(f_target);
+  if (!f_container.open(QIODevice::WriteOnly))
+  {
+    out() << "could not write " << f_target << endl;
+    return false;
+  }
+
+  //the header is filled in once the offsets are known
+  f_container.write(QByteArray(AOFrameContainer::header_size, '\0'));
+  quint64 f_offset = AOFrameContainer::header_size;
+
+  QVector<animation_entry> f_animations;
+  QByteArray f_names;
+  quint64 f_raw_total = 0;
+
+  for (QString f_file : f_sources)
+  {
+    animation_entry f_entry;
+    f_entry.name = f_file.toLower().toUtf8();
+
+    if (!compile_animation(f_dir.filePath(f_file), f_entry, f_container, f_offset, p_indexed, p_lz4))
+      continue;
+
+    f_entry.name_offset = f_names.size();
+    f_names.append(f_entry.name);
+    f_raw_total += quint64(f_entry.width) * f_entry.height * 4 * f_entry.frames.size();
+
+    f_animations.append(f_entry);
+  }
+
+  QDataStream f_stream(&f_container);
+  f_stream.setByteOrder(QDataStream::LittleEndian);
+
+  align(f_container, f_offset);
+
+  for (animation_entry &f_entry : f_animations)
+  {
+    f_entry.frames_offset = f_offset;
+
+    for (const frame_entry &f_frame : f_entry.frames)
+      f_stream << f_frame.delay << f_frame.stored_size << f_frame.data_offset << quint64(0);
+
+    f_offset += quint64(f_entry.frames.size()) * AOFrameContainer::frame_size;
+  }
+
+  quint64 f_animations_offset = f_offset;
+
+  for (const animation_entry &f_entry : f_animations)
+  {
+    f_stream << f_entry.name_offset << quint32(f_entry.name.size()) << f_entry.width << f_entry.height
+             << quint32(f_entry.frames.size()) << f_entry.flags << f_entry.frames_offset << f_entry.palette_offset
+             << f_entry.palette_size << quint32(0) << f_entry.source_size << f_entry.source_time;
+  }
+
+  quint64 f_names_offset = f_animations_offset + quint64(f_animations.size()) * AOFrameContainer::animation_size;
+  f_container.write(f_names);
+
+  f_container.seek(0);
+  f_container.write("AOFC", 4);
+  f_stream << AOFrameContainer::container_version << quint32(f_animations.size()) << quint32(0)
+           << f_animations_offset << f_names_offset;
+
+  if (!f_container.commit())
+  {
+    out() << "could not write " << f_target << ": " << f_container.errorString() << endl;
+    return false;
+  }
+
+  //read everything back the way the client does, a broken container is worse than none
+  AOFrameContainer f_check;
+  bool f_valid = f_check.open(f_target);
+
+  for (int n_animation = 0 ; f_valid && n_animation < f_animations.size() ; ++n_animation)
+  {
+    for (int n_frame = 0 ; f_valid && n_frame < f_check.get_frame_count(n_animation) ; ++n_frame)
+      f_valid = !f_check.read_frame(n_animation, n_frame).isNull();
+  }
+
+  f_check.close();
+
+  if (!f_valid)
+  {
+    out() << f_target << " doesn't read back, removing it" << endl;
+    QFile::remove(f_target);
+    return false;
+  }
+
+  out() << p_folder << ": " << f_animations.size() << " animations, " << f_raw_total << " bytes of frames in "
+        << QFileInfo(f_target).size() << " bytes" << endl;
+
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QStringList f_args = app.arguments().mid(1);
+  bool f_indexed = f_args.removeAll("--indexed");
+  bool f_lz4 = f_args.removeAll("--lz4");
+  bool f_all = f_args.removeAll("--all");
+
+  if (f_args.isEmpty() || (f_all && f_args.size() != 1))
+  {
+    out() << "usage: aoc [--indexed] [--lz4] <character folder>..." << endl;
+    out() << "       aoc [--indexed] [--lz4] --all <characters folder>" << endl;
+    return 1;
+  }
+
+  QStringList f_folders;
+
+  if (f_all)
+  {
+    QDir f_characters(f_args.first());
+    for (QString f_folder : f_characters.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+      f_folders.append(f_characters.filePath(f_folder));
+  }
+  else
+    f_folders = f_args;
+
+  bool f_success = true;
+
+  for (QString f_folder : f_folders)
+  {
+    if (!compile_character(f_folder, f_indexed, f_lz4))
+      f_success = false;
+  }
+
+  return f_success ? 0 : 1;
+}
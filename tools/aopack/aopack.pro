@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Builds base.aopk asset packs out of a base/ directory
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = aopack
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += main.cpp \
+    ../../aoassetpack.cpp
+
+HEADERS += ../../aoassetpack.hpp
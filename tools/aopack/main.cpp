@@ -0,0 +1,193 @@
+#include "aoassetpack.hpp"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QStringList>
+#include <QVector>
+#include <QTextStream>
+
+struct pack_entry
+{
+  QByteArray key;
+  quint32 hash = 0;
+  quint32 flags = 0;
+  quint32 name_offset = 0;
+  quint64 data_offset = 0;
+  quint32 stored_size = 0;
+  quint32 size = 0;
+};
+
+//formats that are compressed already, zlib won't get anything out of them
+static const QStringList stored_suffixes = {"png", "apng", "gif", "jpg", "jpeg", "webp", "ogg", "opus", "mp3"};
+
+static QTextStream &out()
+{
+  static QTextStream f_stream(stdout);
+  return f_stream;
+}
+
+static quint32 get_bucket_count(int p_entries)
+{
+  //at most half full, keeps the probe chains short
+  quint32 f_count = 16;
+  while (f_count < quint32(p_entries) * 2)
+    f_count *= 2;
+  return f_count;
+}
+
+static bool build_pack(QString p_source, QString p_target, bool p_compress)
+{
+  QDir f_source_dir(p_source);
+  if (!f_source_dir.exists())
+  {
+    out() << "no such directory: " << p_source << endl;
+    return false;
+  }
+
+  QString f_root = f_source_dir.absolutePath() + "/";
+
+  //walked before the pack is opened, so its temporary file can't end up packed into itself
+  QVector<QFileInfo> f_infos;
+  QDirIterator it(f_source_dir.absolutePath(), QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden,
+                  QDirIterator::Subdirectories);
+
+  while (it.hasNext())
+  {
+    it.next();
+
+    if (it.fileInfo().suffix().toLower() == "aopk")
+      continue;
+
+    f_infos.append(it.fileInfo());
+  }
+
+  QSaveFile f_pack(p_target);
+  if (!f_pack.open(QIODevice::WriteOnly))
+  {
+    out() << "could not write " << p_target << endl;
+    return false;
+  }
+
+  QDataStream f_stream(&f_pack);
+  f_stream.setByteOrder(QDataStream::LittleEndian);
+
+  //the header is filled in once the offsets are known
+  f_pack.write(QByteArray(AOAssetPack::header_size, '\0'));
+
+  QVector<pack_entry> f_entries;
+  QByteArray f_names;
+  quint64 f_offset = AOAssetPack::header_size;
+  quint64 f_raw_total = 0;
+
+  for (const QFileInfo &f_info : f_infos)
+  {
+    QString f_path = f_info.filePath();
+
+    pack_entry f_entry;
+    f_entry.key = AOAssetPack::get_key(f_path.mid(f_root.size())).toUtf8();
+    f_entry.hash = AOAssetPack::hash_key(f_entry.key);
+    f_entry.name_offset = f_names.size();
+    f_entry.data_offset = f_offset;
+    f_names.append(f_entry.key);
+
+    if (f_info.isDir())
+      f_entry.flags = AOAssetPack::DIRECTORY;
+    else
+    {
+      QFile f_file(f_path);
+      if (!f_file.open(QIODevice::ReadOnly))
+      {
+        out() << "skipping unreadable " << f_path << endl;
+        f_names.chop(f_entry.key.size());
+        continue;
+      }
+
+      QByteArray f_data = f_file.readAll();
+      f_entry.size = f_data.size();
+      f_raw_total += f_data.size();
+
+      if (p_compress && !stored_suffixes.contains(f_info.suffix().toLower()))
+      {
+        QByteArray f_compressed = qCompress(f_data, 9);
+
+        //only worth the decompression if it saves a good chunk
+        if (f_compressed.size() < f_data.size() - f_data.size() / 8)
+        {
+          f_data = f_compressed;
+          f_entry.flags |= AOAssetPack::COMPRESSED;
+        }
+      }
+
+      f_entry.stored_size = f_data.size();
+      f_pack.write(f_data);
+      f_offset += f_data.size();
+    }
+
+    f_entries.append(f_entry);
+  }
+
+  quint64 f_names_offset = f_offset;
+  f_pack.write(f_names);
+
+  quint64 f_entries_offset = f_names_offset + f_names.size();
+  for (const pack_entry &f_entry : f_entries)
+  {
+    f_stream << f_entry.hash << f_entry.flags << f_entry.name_offset << quint32(f_entry.key.size())
+             << f_entry.data_offset << f_entry.stored_size << f_entry.size;
+  }
+
+  quint32 f_bucket_count = get_bucket_count(f_entries.size());
+  QVector<quint32> f_buckets(f_bucket_count, 0);
+
+  for (int n_entry = 0 ; n_entry < f_entries.size() ; ++n_entry)
+  {
+    quint32 f_slot = f_entries.at(n_entry).hash & (f_bucket_count - 1);
+
+    //linear probing, the same walk the reader does
+    while (f_buckets.at(f_slot) != 0)
+      f_slot = (f_slot + 1) & (f_bucket_count - 1);
+
+    f_buckets[f_slot] = n_entry + 1;
+  }
+
+  quint64 f_buckets_offset = f_entries_offset + quint64(f_entries.size()) * AOAssetPack::entry_size;
+  for (quint32 f_bucket : f_buckets)
+    f_stream << f_bucket;
+
+  f_pack.seek(0);
+  f_pack.write("AOPK", 4);
+  f_stream << AOAssetPack::pack_version << quint32(f_entries.size()) << f_bucket_count
+           << f_buckets_offset << f_entries_offset << f_names_offset;
+
+  if (!f_pack.commit())
+  {
+    out() << "could not write " << p_target << ": " << f_pack.errorString() << endl;
+    return false;
+  }
+
+  out() << "packed " << f_entries.size() << " entries, " << f_raw_total << " bytes into "
+        << QFileInfo(p_target).size() << " bytes" << endl;
+
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QStringList f_args = app.arguments().mid(1);
+  bool f_compress = !f_args.removeAll("--no-compress");
+
+  if (f_args.size() != 2)
+  {
+    out() << "usage: aopack [--no-compress] <base directory> <output.aopk>" << endl;
+    return 1;
+  }
+
+  return build_pack(f_args.at(0), f_args.at(1), f_compress) ? 0 : 1;
+}
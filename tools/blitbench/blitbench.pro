@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# Times scale_frame against QImage::scaled and QImage::mirrored
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+TARGET = blitbench
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += main.cpp \
+    ../../aoblit.cpp
+
+HEADERS += ../../aoblit.hpp
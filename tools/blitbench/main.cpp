@@ -0,0 +1,88 @@
+#include "aoblit.hpp"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QStringList>
+#include <QTextStream>
+
+static QTextStream &out()
+{
+  static QTextStream f_stream(stdout);
+  return f_stream;
+}
+
+//what the client did before it had a kernel of its own
+static QImage qt_scale(const QImage &p_image, QSize p_size, bool p_flipped)
+{
+  QImage f_image = p_image.scaled(p_size);
+
+  if (p_flipped)
+    f_image = f_image.mirrored(true, false);
+
+  return f_image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+//Returns the average microseconds per frame over p_reps runs
+template <typename F>
+static double time_frames(int p_reps, F p_scale)
+{
+  //once to warm the caches up
+  p_scale();
+
+  QElapsedTimer f_timer;
+  f_timer.start();
+
+  for (int n_rep = 0 ; n_rep < p_reps ; ++n_rep)
+    p_scale();
+
+  return f_timer.nsecsElapsed() / 1000.0 / p_reps;
+}
+
+int main(int argc, char *argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  QStringList f_args = app.arguments().mid(1);
+  int f_reps = f_args.isEmpty() ? 500 : f_args.at(0).toInt();
+
+  if (f_reps <= 0)
+  {
+    out() << "usage: blitbench [repetitions]" << endl;
+    return 1;
+  }
+
+  //a base sized sprite with some noise in it, so nothing gets special cased
+  QImage f_sprite(256, 192, QImage::Format_ARGB32_Premultiplied);
+  for (int n_row = 0 ; n_row < f_sprite.height() ; ++n_row)
+  {
+    quint32 *f_line = reinterpret_cast<quint32*>(f_sprite.scanLine(n_row));
+    for (int n_pixel = 0 ; n_pixel < f_sprite.width() ; ++n_pixel)
+      f_line[n_pixel] = quint32(n_row * 2654435761u + n_pixel * 40503u) | 0xff000000u;
+  }
+
+  out() << "256x192 sprite, " << f_reps << " frames each, microseconds per frame" << endl;
+
+  for (int f_factor = 1 ; f_factor <= 4 ; ++f_factor)
+  {
+    for (bool f_flipped : {false, true})
+    {
+      QSize f_size = f_sprite.size() * f_factor;
+
+      //the two have to agree, or the numbers mean nothing
+      if (scale_frame(f_sprite, f_size, f_flipped) != qt_scale(f_sprite, f_size, f_flipped))
+      {
+        out() << "x" << f_factor << (f_flipped ? " flipped" : "") << ": results differ" << endl;
+        return 1;
+      }
+
+      double f_qt = time_frames(f_reps, [&] { qt_scale(f_sprite, f_size, f_flipped); });
+      double f_kernel = time_frames(f_reps, [&] { scale_frame(f_sprite, f_size, f_flipped); });
+
+      out() << "x" << f_factor << (f_flipped ? " flipped" : "        ") << "  qt " << f_qt
+            << "  kernel " << f_kernel << "  " << f_qt / f_kernel << "x" << endl;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include "aofilewriter.hpp"
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QKeyEvent>
+#include <QStringList>
+#include <QTextEdit>
+#include <QTextStream>
+#include <QTimer>
+#include <QVector>
+
+#include <algorithm>
+
+static QTextStream &out()
+{
+  static QTextStream f_stream(stdout);
+  return f_stream;
+}
+
+//the courtroom waits this long after the last keystroke
+static const int note_save_delay = 750;
+
+//what write_note did before the file writer, on every keystroke
+static void write_now(QString p_text, QString p_file)
+{
+  QFile f_log(p_file);
+  if (f_log.open(QIODevice::WriteOnly | QFile::Text))
+  {
+    QTextStream out(&f_log);
+    out << p_text;
+  }
+}
+
+//Keeps the event loop running for p_msecs, like a user who stopped typing
+static void idle(int p_msecs)
+{
+  QEventLoop f_loop;
+  QTimer::singleShot(p_msecs, &f_loop, &QEventLoop::quit);
+  f_loop.exec();
+}
+
+//Types p_keys characters into p_edit, pausing longer than the save delay after every p_burst of them,
+//and returns how long each one took, in microseconds. The first keystroke after each pause also goes
+//into p_after_pause, it lands while the save that the pause let through is being written
+static QVector<double> type(QTextEdit *p_edit, int p_keys, int p_burst, QVector<double> &p_after_pause)
+{
+  QVector<double> f_times;
+  QElapsedTimer f_timer;
+
+  for (int n_key = 0 ; n_key < p_keys ; ++n_key)
+  {
+    bool is_after_pause = n_key > 0 && n_key % p_burst == 0;
+    if (is_after_pause)
+      idle(note_save_delay + 50);
+
+    QKeyEvent f_press(QEvent::KeyPress, Qt::Key_A, Qt::NoModifier, "a");
+    QKeyEvent f_release(QEvent::KeyRelease, Qt::Key_A, Qt::NoModifier, "a");
+
+    f_timer.start();
+    QApplication::sendEvent(p_edit, &f_press);
+    QApplication::sendEvent(p_edit, &f_release);
+    QApplication::processEvents();
+    double f_time = f_timer.nsecsElapsed() / 1000.0;
+
+    f_times.append(f_time);
+    if (is_after_pause)
+      p_after_pause.append(f_time);
+  }
+
+  return f_times;
+}
+
+static void report(QString p_name, QVector<double> p_times)
+{
+  if (p_times.isEmpty())
+    return;
+
+  std::sort(p_times.begin(), p_times.end());
+
+  double f_total = 0;
+  for (double f_time : p_times)
+    f_total += f_time;
+
+  out() << p_name << ": avg " << f_total / p_times.size() << " us, median " << p_times.at(p_times.size() / 2)
+        << " us, p99 " << p_times.at(p_times.size() * 99 / 100) << " us, max " << p_times.last() << " us" << endl;
+}
+
+int main(int argc, char *argv[])
+{
+  QApplication app(argc, argv);
+
+  QStringList f_args = app.arguments().mid(1);
+  int f_keys = f_args.isEmpty() ? 200 : f_args.at(0).toInt();
+  int f_burst = f_args.size() < 2 ? 20 : f_args.at(1).toInt();
+
+  if (f_keys <= 0 || f_burst <= 0)
+  {
+    out() << "usage: notebench [keystrokes] [keystrokes between pauses] (-platform offscreen works too)" << endl;
+    return 1;
+  }
+
+  //about 1 MB of case notes
+  QString f_line = "Exhibit 12 contradicts the witness statement about the time of the incident.\n";
+  QString f_note;
+  while (f_note.size() < 1024 * 1024)
+    f_note += f_line;
+
+  QString f_file = QDir::temp().filePath("notebench.txt");
+  out() << f_keys << " keystrokes into a " << f_note.size() / 1024 << " KiB note, saved to " << f_file
+        << ", pausing " << note_save_delay + 50 << " ms every " << f_burst << endl;
+
+  //before: the whole text snapshotted and rewritten per keystroke
+  {
+    QTextEdit f_edit;
+    f_edit.setPlainText(f_note);
+    f_edit.moveCursor(QTextCursor::End);
+
+    QObject::connect(&f_edit, &QTextEdit::textChanged, [&] {
+      write_now(f_edit.toPlainText(), f_file);
+    });
+
+    QVector<double> f_after_pause;
+    report("save per keystroke", type(&f_edit, f_keys, f_burst, f_after_pause));
+    report("  after a pause", f_after_pause);
+  }
+
+  //after: a countdown restarted per keystroke, the snapshot goes to the writer thread
+  {
+    QTextEdit f_edit;
+    f_edit.setPlainText(f_note);
+    f_edit.moveCursor(QTextCursor::End);
+
+    AOFileWriter f_writer;
+    QTimer f_save_timer;
+    f_save_timer.setSingleShot(true);
+    f_save_timer.setInterval(note_save_delay);
+
+    QObject::connect(&f_edit, &QTextEdit::textChanged, [&] {
+      f_save_timer.start();
+    });
+
+    //what the save costs the GUI thread, the rest happens on the writer's
+    QVector<double> f_snapshots;
+    QObject::connect(&f_save_timer, &QTimer::timeout, [&] {
+      QElapsedTimer f_timer;
+      f_timer.start();
+      f_writer.write_file(f_file, f_edit.toPlainText().toLocal8Bit());
+      f_writer.start_write();
+      f_snapshots.append(f_timer.nsecsElapsed() / 1000.0);
+    });
+
+    QVector<double> f_after_pause;
+    report("debounced save", type(&f_edit, f_keys, f_burst, f_after_pause));
+    report("  after a pause", f_after_pause);
+    report("  snapshot per save", f_snapshots);
+
+    f_save_timer.stop();
+    f_writer.flush();
+  }
+
+  QFile::remove(f_file);
+
+  return 0;
+}
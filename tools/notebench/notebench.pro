@@ -0,0 +1,20 @@
+#-------------------------------------------------
+#
+# Times typing into a large note, saved on every keystroke or debounced
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+
+TARGET = notebench
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += main.cpp \
+    ../../aofilewriter.cpp
+
+HEADERS += ../../aofilewriter.hpp
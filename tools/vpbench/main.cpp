@@ -0,0 +1,263 @@
+#include "aoviewport.hpp"
+#include "aoblit.hpp"
+
+#include <QApplication>
+#include <QImage>
+#include <QLabel>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <ctime>
+
+static QTextStream &out()
+{
+  static QTextStream f_stream(stdout);
+  return f_stream;
+}
+
+//the layers of the courtroom, bottom to top
+enum layer_id
+{
+  BACKGROUND, SPEEDLINES, CHARACTER, DESK, LEGACY_DESK, EVIDENCE,
+  CHATBOX, SHOWNAME_IMAGE, TESTIMONY, EFFECT, WTCE, OBJECTION, LAYER_COUNT
+};
+
+struct frames
+{
+  QVector<QPixmap> pixmaps;
+  QVector<QRect> opaque;
+  //milliseconds per frame, 0 for a still image
+  int delay = 0;
+};
+
+struct scenario
+{
+  QString name;
+  //what is shown on each layer, layers without frames stay hidden
+  QVector<frames> layers;
+  //the message on the chatbox is revealed one character per this many milliseconds
+  int text_delay = 40;
+};
+
+//Returns a transparent image of p_size with noise in p_opaque, different for every p_seed
+static QImage make_image(QSize p_size, QRect p_opaque, int p_seed)
+{
+  QImage f_image(p_size, QImage::Format_ARGB32_Premultiplied);
+  f_image.fill(Qt::transparent);
+
+  for (int n_row = p_opaque.top() ; n_row <= p_opaque.bottom() ; ++n_row)
+  {
+    quint32 *f_line = reinterpret_cast<quint32*>(f_image.scanLine(n_row));
+    for (int n_pixel = p_opaque.left() ; n_pixel <= p_opaque.right() ; ++n_pixel)
+      f_line[n_pixel] = quint32(n_row * 2654435761u + n_pixel * 40503u + p_seed * 97u) | 0xff000000u;
+  }
+
+  return f_image;
+}
+
+static frames make_frames(QSize p_size, QRect p_opaque, int p_count, int p_delay)
+{
+  frames f_frames;
+  f_frames.delay = p_delay;
+
+  for (int n_frame = 0 ; n_frame < p_count ; ++n_frame)
+  {
+    QImage f_image = make_image(p_size, p_opaque, n_frame);
+    f_frames.opaque.append(opaque_rect(f_image));
+    f_frames.pixmaps.append(QPixmap::fromImage(f_image));
+  }
+
+  return f_frames;
+}
+
+//A courtroom viewport, either the way it was before the viewport composited anything or with it
+class layer_stack
+{
+public:
+  layer_stack(QSize p_size, bool p_composited)
+  {
+    m_window.resize(p_size);
+
+    QWidget *f_parent = &m_window;
+
+    if (p_composited)
+    {
+      m_viewport = new AOViewport(&m_window);
+      m_viewport->resize(p_size);
+      f_parent = m_viewport;
+    }
+
+    for (int n_layer = 0 ; n_layer < LAYER_COUNT ; ++n_layer)
+    {
+      QLabel *f_label = new QLabel(f_parent);
+      f_label->resize(p_size);
+      f_label->hide();
+      m_labels.append(f_label);
+
+      if (m_viewport != nullptr)
+        m_viewport->add_layer(f_label);
+    }
+
+    //the message, on top of the chatbox like ui_vp_message
+    m_text = new QLabel(m_labels.at(CHATBOX));
+    m_text->setGeometry(p_size.width() / 40, p_size.height() * 3 / 4, p_size.width() * 19 / 20, p_size.height() / 5);
+    m_text->setWordWrap(true);
+    m_text->setStyleSheet("color: white");
+
+    m_window.show();
+  }
+
+  void set(int n_layer, const frames &p_frames, int n_frame)
+  {
+    if (m_viewport != nullptr)
+      AOViewport::set_pixmap(m_labels.at(n_layer), p_frames.pixmaps.at(n_frame), p_frames.opaque.at(n_frame));
+    else
+      m_labels.at(n_layer)->setPixmap(p_frames.pixmaps.at(n_frame));
+  }
+
+  void set_visible(int n_layer, bool p_visible) {m_labels.at(n_layer)->setVisible(p_visible);}
+  void set_text(QString p_text) {m_text->setText(p_text);}
+
+private:
+  QWidget m_window;
+  AOViewport *m_viewport = nullptr;
+  QVector<QLabel*> m_labels;
+  QLabel *m_text;
+};
+
+//Plays p_scenario for p_seconds of animation on 60 Hz ticks, as fast as it goes, and returns the
+//milliseconds of CPU time each second of animation took
+static double run(const scenario &p_scenario, QSize p_size, bool p_composited, int p_seconds)
+{
+  layer_stack f_stack(p_size, p_composited);
+  QVector<int> f_shown(LAYER_COUNT, -1);
+
+  for (int n_layer = 0 ; n_layer < LAYER_COUNT ; ++n_layer)
+  {
+    bool is_shown = !p_scenario.layers.at(n_layer).pixmaps.isEmpty();
+    f_stack.set_visible(n_layer, is_shown);
+
+    if (is_shown)
+    {
+      f_stack.set(n_layer, p_scenario.layers.at(n_layer), 0);
+      f_shown[n_layer] = 0;
+    }
+  }
+
+  //the first full paint isn't what we're after
+  QApplication::processEvents();
+
+  QString f_message = "Objection! The witness could not have seen the defendant from the window, "
+                      "the curtains were drawn the whole evening.";
+
+  std::clock_t f_start = std::clock();
+
+  for (int n_tick = 0 ; n_tick < p_seconds * 60 ; ++n_tick)
+  {
+    int f_time = n_tick * 1000 / 60;
+
+    for (int n_layer = 0 ; n_layer < LAYER_COUNT ; ++n_layer)
+    {
+      const frames &f_frames = p_scenario.layers.at(n_layer);
+      if (f_frames.pixmaps.isEmpty() || f_frames.delay <= 0)
+        continue;
+
+      int f_frame = (f_time / f_frames.delay) % f_frames.pixmaps.size();
+      if (f_frame != f_shown.at(n_layer))
+      {
+        f_stack.set(n_layer, f_frames, f_frame);
+        f_shown[n_layer] = f_frame;
+      }
+    }
+
+    //starts over once the whole message is out
+    int f_length = (f_time / p_scenario.text_delay) % (f_message.size() + 1);
+    f_stack.set_text(f_message.left(f_length));
+
+    QApplication::processEvents();
+  }
+
+  return double(std::clock() - f_start) * 1000.0 / CLOCKS_PER_SEC / p_seconds;
+}
+
+int main(int argc, char *argv[])
+{
+  //nothing needs to show up on the screen
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    qputenv("QT_QPA_PLATFORM", "offscreen");
+
+  QApplication app(argc, argv);
+
+  QStringList f_args = app.arguments().mid(1);
+  int f_seconds = f_args.isEmpty() ? 10 : f_args.at(0).toInt();
+  int f_scale = f_args.size() < 2 ? 3 : f_args.at(1).toInt();
+
+  if (f_seconds <= 0 || f_scale <= 0)
+  {
+    out() << "usage: vpbench [seconds of animation] [viewport scale]" << endl;
+    return 1;
+  }
+
+  //the base viewport is 256x192
+  QSize f_size = QSize(256, 192) * f_scale;
+  int f_w = f_size.width();
+  int f_h = f_size.height();
+
+  frames f_background = make_frames(f_size, QRect(0, 0, f_w, f_h), 1, 0);
+  frames f_talking = make_frames(f_size, QRect(f_w * 3 / 10, f_h / 8, f_w * 2 / 5, f_h * 7 / 8), 8, 100);
+  frames f_idle = make_frames(f_size, QRect(f_w * 3 / 10, f_h / 8, f_w * 2 / 5, f_h * 7 / 8), 4, 200);
+  frames f_desk = make_frames(f_size, QRect(0, f_h * 3 / 4, f_w, f_h / 4), 1, 0);
+  frames f_chatbox = make_frames(f_size, QRect(0, f_h * 3 / 5, f_w, f_h * 2 / 5), 1, 0);
+  frames f_speedlines = make_frames(f_size, QRect(0, 0, f_w, f_h), 4, 50);
+  frames f_bubble = make_frames(f_size, QRect(f_w / 8, f_h / 4, f_w * 3 / 4, f_h / 2), 10, 40);
+
+  QVector<scenario> f_scenarios;
+
+  scenario f_scenario;
+  f_scenario.layers.resize(LAYER_COUNT);
+
+  f_scenario.name = "talking";
+  f_scenario.layers[BACKGROUND] = f_background;
+  f_scenario.layers[CHARACTER] = f_talking;
+  f_scenario.layers[DESK] = f_desk;
+  f_scenario.layers[CHATBOX] = f_chatbox;
+  f_scenarios.append(f_scenario);
+
+  f_scenario.name = "idle";
+  f_scenario.layers[CHARACTER] = f_idle;
+  f_scenario.layers[CHATBOX] = frames();
+  f_scenario.text_delay = 1000000;
+  f_scenarios.append(f_scenario);
+
+  f_scenario.name = "speedlines";
+  f_scenario.layers[BACKGROUND] = frames();
+  f_scenario.layers[DESK] = frames();
+  f_scenario.layers[SPEEDLINES] = f_speedlines;
+  f_scenario.layers[CHARACTER] = f_talking;
+  f_scenario.layers[CHATBOX] = f_chatbox;
+  f_scenario.text_delay = 40;
+  f_scenarios.append(f_scenario);
+
+  f_scenario.name = "objection";
+  f_scenario.layers[SPEEDLINES] = frames();
+  f_scenario.layers[BACKGROUND] = f_background;
+  f_scenario.layers[DESK] = f_desk;
+  f_scenario.layers[CHATBOX] = frames();
+  f_scenario.layers[OBJECTION] = f_bubble;
+  f_scenario.text_delay = 1000000;
+  f_scenarios.append(f_scenario);
+
+  out() << f_w << "x" << f_h << " viewport, " << f_seconds << " s of animation each, ms of CPU per second" << endl;
+
+  for (const scenario &f_run : f_scenarios)
+  {
+    double f_labels = run(f_run, f_size, false, f_seconds);
+    double f_viewport = run(f_run, f_size, true, f_seconds);
+
+    out() << f_run.name.leftJustified(12) << "labels " << f_labels << "  viewport " << f_viewport
+          << "  " << (f_viewport > 0 ? f_labels / f_viewport : 0) << "x" << endl;
+  }
+
+  return 0;
+}
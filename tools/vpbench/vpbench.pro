@@ -0,0 +1,22 @@
+#-------------------------------------------------
+#
+# Measures CPU time per second of courtroom animation, stacked labels against the viewport
+#
+#-------------------------------------------------
+
+QT       += core gui widgets
+
+TARGET = vpbench
+TEMPLATE = app
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += main.cpp \
+    ../../aoviewport.cpp \
+    ../../aoblit.cpp
+
+HEADERS += ../../aoviewport.hpp \
+    ../../aoblit.hpp